@@ -10,6 +10,10 @@
 //
 #include "ATLTileCalTBActInitialization.hh"
 #include "ATLTileCalTBDetConstruction.hh"
+#include "ATLTileCalTBShard.hh"
+#ifdef ATLTileCalTB_MPI
+#include "ATLTileCalTBMPI.hh"
+#endif
 #ifdef G4_USE_FLUKA
 // include the FTFP_BERT PL custmized with fluka
 // hadron inelastic process
@@ -18,23 +22,31 @@
 
 // Includers from Geant4
 //
+#include "G4Version.hh"
+#if G4VERSION_NUMBER >= 1070 // >= Geant4-10.7.0
+#include "G4RunManagerFactory.hh"
+#endif
+#ifdef ATLTileCalTB_SubEvent // >= Geant4-11.2.0
+#include "G4SubEvtRunManager.hh"
+#endif
 #ifdef G4MULTITHREADED
 #include "G4MTRunManager.hh"
 #include "G4Threading.hh"
 #else
 #include "G4RunManager.hh"
 #endif
-// #include "G4RunManagerFactory.hh" //only available from 10.7 on
 #include "G4GDMLParser.hh"
 #include "G4PhysListFactory.hh"
 #include "G4UIExecutive.hh"
 #include "G4UIcommand.hh"
 #include "G4UImanager.hh"
-#include "G4Version.hh"
 #include "G4VisExecutive.hh"
 #if G4VERSION_NUMBER >= 1110 // >= Geant4-11.1.0
 #include "G4FTFTunings.hh"
 #endif
+#ifdef ATLTileCalTB_FastSim
+#include "G4FastSimulationPhysics.hh"
+#endif
 
 // Includers from FLUKAIntegration
 //
@@ -51,6 +63,13 @@ void PrintHelp() {
          << "  -u UISESSION    string of the Geant4 UI session to use\n"
          << "  -t THREADS      number of threads to use in the simulation\n"
          << "  -p PHYSICSLIST  string of the physics list to use\n"
+         << "  -r RUNMANAGER   run manager type: serial, mt (default in MT builds),\n"
+         << "                  tasking or tbb (Geant4-10.7 or later), subevt (sub-event\n"
+         << "                  parallel builds)\n"
+         << "  -g EVENTMODULO  number of events per worker request (mt) or per task\n"
+         << "                  (tasking, tbb), number of tracks per sub-event (subevt)\n"
+         << "  -s, --shard I/N simulate the events with ID % N == I of each run, seeded\n"
+         << "                  from their run and event IDs\n"
          << "  -h              print this help and exit\n"
          << G4endl;
 }
@@ -87,7 +106,11 @@ int main(int argc, char **argv) {
   G4String custom_pl = "FTFP_BERT"; // default physics list
 #ifdef G4MULTITHREADED
   G4int nThreads = G4Threading::G4GetNumberOfCores();
+  G4String runManagerType = "mt";
+#else
+  G4String runManagerType = "serial";
 #endif
+  G4int eventModulo = 0; // 0: Geant4 default
 
   // CLI parsing
   for (G4int i = 1; i < argc; i = i + 2) {
@@ -102,6 +125,17 @@ int main(int argc, char **argv) {
       nThreads = G4UIcommand::ConvertToInt(argv[i + 1]);
     }
 #endif
+    else if (G4String(argv[i]) == "-r")
+      runManagerType = argv[i + 1];
+    else if (G4String(argv[i]) == "-g")
+      eventModulo = G4UIcommand::ConvertToInt(argv[i + 1]);
+    else if (G4String(argv[i]) == "-s" || G4String(argv[i]) == "--shard") {
+      if (i + 1 >= argc ||
+          !ATLTileCalTBShard::GetInstance()->SetShard(argv[i + 1])) {
+        CLIOutputs::PrintError();
+        return 1;
+      }
+    }
     else if (G4String(argv[i]) == "-h") {
       CLIOutputs::PrintHelp();
       return 0;
@@ -111,6 +145,16 @@ int main(int argc, char **argv) {
     }
   }
 
+#ifdef ATLTileCalTB_MPI
+  // MPI runs are batch only and share the events among the ranks
+  // instead of sharding them
+  if (!macro.size() || ATLTileCalTBShard::GetInstance()->IsActive()) {
+    CLIOutputs::PrintError();
+    return 1;
+  }
+  ATLTileCalTBMPI::GetInstance()->Initialize(&argc, &argv);
+#endif
+
 #ifndef G4_USE_FLUKA
 #if G4VERSION_NUMBER >= 1110 // >= Geant4-11.1.0
   G4bool UseFTFTune = false;
@@ -138,13 +182,76 @@ int main(int argc, char **argv) {
   // Construct the run manager
   //
 
+#if G4VERSION_NUMBER >= 1070
+  // The type is forced, G4RUN_MANAGER_TYPE does not override it
+  G4RunManagerType runManagerEnum;
+  if (runManagerType == "serial")
+    runManagerEnum = G4RunManagerType::SerialOnly;
+  else if (runManagerType == "mt")
+    runManagerEnum = G4RunManagerType::MTOnly;
+  else if (runManagerType == "tasking")
+    runManagerEnum = G4RunManagerType::TaskingOnly;
+  else if (runManagerType == "tbb")
+    runManagerEnum = G4RunManagerType::TBBOnly;
+#ifdef ATLTileCalTB_SubEvent
+  else if (runManagerType == "subevt")
+    runManagerEnum = G4RunManagerType::SubEvtOnly;
+#endif
+  else {
+    CLIOutputs::PrintError();
+    return 1;
+  }
+  auto runManager = G4RunManagerFactory::CreateRunManager(runManagerEnum);
 #ifdef G4MULTITHREADED
+  if (nThreads > 0) {
+    runManager->SetNumberOfThreads(nThreads);
+  }
+  // Tasking and TBB run managers derive from the MT one
+  auto mtRunManager = dynamic_cast<G4MTRunManager *>(runManager);
+#ifdef ATLTileCalTB_SubEvent
+  // The stacking action sends the secondaries of the primary hadron
+  // interactions to sub-events of type 0
+  auto subEvtRunManager = dynamic_cast<G4SubEvtRunManager *>(runManager);
+  if (subEvtRunManager) {
+    subEvtRunManager->RegisterSubEventType(0, eventModulo > 0 ? eventModulo : 100);
+    mtRunManager = nullptr;
+    // Sub-events take their seeds from the run manager, not from the
+    // run and event IDs
+#ifdef ATLTileCalTB_MPI
+    const G4bool seededEvents = true;
+#else
+    const G4bool seededEvents = ATLTileCalTBShard::GetInstance()->IsActive();
+#endif
+    if (seededEvents) {
+      G4Exception("main()", "MyCode0019", JustWarning,
+                  "Events split in sub-events are not reproducible across shards, ranks and threads");
+    }
+  }
+#endif
+  if (mtRunManager && eventModulo > 0) {
+    mtRunManager->SetEventModulo(eventModulo);
+  }
+#endif
+#else // before Geant4-10.7 only the MT or serial run manager of the build
+#ifdef G4MULTITHREADED
+  if (runManagerType != "mt") {
+    CLIOutputs::PrintError();
+    return 1;
+  }
   auto runManager = new G4MTRunManager;
   if (nThreads > 0) {
     runManager->SetNumberOfThreads(nThreads);
   }
+  if (eventModulo > 0) {
+    runManager->SetEventModulo(eventModulo);
+  }
 #else
+  if (runManagerType != "serial") {
+    CLIOutputs::PrintError();
+    return 1;
+  }
   auto runManager = new G4RunManager;
+#endif
 #endif
 
   // Manadatory Geant4 classes
@@ -158,9 +265,25 @@ int main(int argc, char **argv) {
     return 1;
   }
   auto physicsList = physListFactory->GetReferencePhysList(custom_pl);
+#ifdef ATLTileCalTB_FastSim
+  // EM shower fast simulation in the Tile modules (parameterized and frozen showers)
+  auto fastSimulationPhysics = new G4FastSimulationPhysics();
+  fastSimulationPhysics->ActivateFastSimulation("e-");
+  fastSimulationPhysics->ActivateFastSimulation("e+");
+  fastSimulationPhysics->ActivateFastSimulation("gamma");
+  physicsList->RegisterPhysics(fastSimulationPhysics);
+#endif
   runManager->SetUserInitialization(physicsList);
 #else // build the customized FTFP_BERT PL with Flula.Cern
   auto physList = new G4_CernFLUKAHadronInelastic_FTFP_BERT;
+#ifdef ATLTileCalTB_FastSim
+  // EM shower fast simulation in the Tile modules (parameterized and frozen showers)
+  auto fastSimulationPhysics = new G4FastSimulationPhysics();
+  fastSimulationPhysics->ActivateFastSimulation("e-");
+  fastSimulationPhysics->ActivateFastSimulation("e+");
+  fastSimulationPhysics->ActivateFastSimulation("gamma");
+  physList->RegisterPhysics(fastSimulationPhysics);
+#endif
   runManager->SetUserInitialization(physList);
   // Initialize FLUKA <-> G4 particles conversions tables.
   fluka_particle_table::initialize();
@@ -232,6 +355,9 @@ int main(int argc, char **argv) {
   //
   delete visManager;
   delete runManager;
+#ifdef ATLTileCalTB_MPI
+  ATLTileCalTBMPI::GetInstance()->Finalize();
+#endif
 }
 
 //**************************************************
@@ -9,10 +9,11 @@
 
 #!/usr/bin/env python3
 
+import glob
 import os.path
 import subprocess
 
-from gts.BaseParser import BaseParser, mergeROOT, mktemp
+from gts.BaseParser import BaseParser, mktemp
 from gts.utils import getJSON
 import ROOT
 
@@ -26,11 +27,23 @@ class Test(BaseParser):
         g4ver = jobs[0]['VERSION']
         print('start parsing for Geant4 ' + g4ver + ' with ' + physlist)
 
-        # merge ROOT files
-        root_files = [os.path.join(job["path"],"ATLTileCalTBout_Run0.root") for job in jobs]
+        # link ROOT files, read by the analysis as a chain
+        # sharded jobs (--shard i/N) write ATLTileCalTBout_Run0_Shard<i>of<N>.root
+        # and per-thread builds (WITH_ATLTileCalTB_ThreadFiles) ATLTileCalTBout_Run0*_t<thread>.root,
+        # ATLTileCalTBout_Run0.root is only read without them as it may be the MergeShards.C output
+        root_files = []
+        for job in jobs:
+            for pattern in ("ATLTileCalTBout_Run0_Shard*of*.root", "ATLTileCalTBout_Run0_t*.root",
+                            "ATLTileCalTBout_Run0.root"):
+                job_files = sorted(glob.glob(os.path.join(job["path"], pattern)))
+                if job_files:
+                    root_files += job_files
+                    break
         tempdir = mktemp(template='analysis_'+g4ver+'_'+physlist+'_XXXXXXX', isDir=True)
-        mergeROOT(root_files, os.path.join(tempdir, 'ATLTileCalTBout_RunAll.root'))
-        print('merged ROOT files for Geant4 ' + g4ver + ' with ' + physlist + ' in ' + tempdir)
+        for i, root_file in enumerate(root_files):
+            # named as per-thread files, which the analysis chains without a merged file
+            os.symlink(os.path.abspath(root_file), os.path.join(tempdir, 'ATLTileCalTBout_Run0_t' + str(i) + '.root'))
+        print('linked ' + str(len(root_files)) + ' ROOT files for Geant4 ' + g4ver + ' with ' + physlist + ' in ' + tempdir)
 
         # run analysis
         cmd = ['root', '-b', '-l', '-q', os.path.join(jobs[0]['path'], 'TBrun_all.C')]
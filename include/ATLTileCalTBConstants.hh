@@ -41,9 +41,10 @@ namespace ATLTileCalTBConstants {
     constexpr G4double frame_bin_time = 0.5 * ns;
 
     // Digitization: time window where hit frames are marked as early
+    // (default and maximum, the window used is set in ATLTileCalTBTimeBinning)
     constexpr G4double frame_time_window = 350 * ns;
 
-    // Digitization: amount of early time frames
+    // Digitization: amount of early time frames (size of the hit frame arrays)
     constexpr std::size_t frames = static_cast<std::size_t>(frame_time_window / frame_bin_time);
 
     // Digitization: analog response of the PMT to one photoelectron (0.5ns bins)
@@ -452,6 +453,14 @@ namespace ATLTileCalTBConstants {
         0.00185470,
     };
 
+    // Digitization (optimal filtering): number of samples per pulse and sampling period
+    constexpr std::size_t of_samples = 7;
+    constexpr G4double of_sampling_time = 25 * ns;
+
+    // Digitization (optimal filtering): time of the central sample, i.e. the peak of
+    // the PMT response for a signal at t = 0 (the primary vertex is at the calorimeter)
+    constexpr G4double of_central_sample_time = 75.5 * ns;
+
 }
 
 #endif //ATLTileCalTBConstants_h
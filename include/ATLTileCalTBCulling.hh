@@ -0,0 +1,80 @@
+//**************************************************
+// \file ATLTileCalTBCulling.hh
+// \brief: definition of ATLTileCalTBCulling
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Culling of the tracks that can no longer produce a signal: deposits
+// after the time window of ATLTileCalTBTimeBinning are discarded by the
+// sensitive detector, so a track past the window only costs transport
+// time. The stacking action kills the new tracks created after the
+// window and the stepping action the tracks crossing it. Configured
+// with the /ATLTileCalTB/culling/ commands and shared by all threads.
+
+#ifndef ATLTileCalTBCulling_h
+#define ATLTileCalTBCulling_h 1
+
+//Includers from project files
+//
+#include "ATLTileCalTBTimeBinning.hh"
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+#include "G4GenericMessenger.hh"
+#include "G4Track.hh"
+
+//Includers from C++
+//
+#include <algorithm>
+#include <vector>
+
+//Forward declaration from Geant4
+//
+class G4ParticleDefinition;
+
+class ATLTileCalTBCulling {
+
+    public:
+        static ATLTileCalTBCulling* GetInstance();
+
+        //True if the track is past the time window, below the energy
+        //threshold and of one of the culled particle types
+        G4bool ToBeCulled( const G4Track* track ) const;
+
+        G4bool IsEnabled() const { return fEnabled; }
+        void Print() const;
+
+    private:
+        ATLTileCalTBCulling();
+        ~ATLTileCalTBCulling();
+
+        //Setters used by the messenger
+        void SetParticles( const G4String& names );
+
+        G4bool fEnabled;
+        G4double fEnergyThreshold;
+        G4String fParticleNames;
+        std::vector<const G4ParticleDefinition*> fParticles; //empty for all particles
+        const ATLTileCalTBTimeBinning* fTimeBinning;
+        G4GenericMessenger* fMessenger;
+
+    public:
+        ATLTileCalTBCulling(ATLTileCalTBCulling const&) = delete;
+        void operator=(ATLTileCalTBCulling const&) = delete;
+
+};
+
+inline G4bool ATLTileCalTBCulling::ToBeCulled( const G4Track* track ) const {
+    if ( !fEnabled || track->GetGlobalTime() <= fTimeBinning->GetTimeWindow() ) return false;
+    if ( track->GetKineticEnergy() >= fEnergyThreshold ) return false;
+    return fParticles.empty()
+        || std::find(fParticles.begin(), fParticles.end(), track->GetParticleDefinition()) != fParticles.end();
+}
+
+#endif //ATLTileCalTBCulling_h
+
+//**************************************************
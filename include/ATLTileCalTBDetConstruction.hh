@@ -30,6 +30,7 @@ class ATLTileCalTBDetConstruction : public G4VUserDetectorConstruction {
     private:
         const G4GDMLParser& fParser;
         void DefineVisAttributes();
+        void DefineRegions();
 
 };
 
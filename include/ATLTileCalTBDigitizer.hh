@@ -0,0 +1,178 @@
+//**************************************************
+// \file ATLTileCalTBDigitizer.hh
+// \brief: definition of ATLTileCalTBDigitizer
+//         class template
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Convolution engine for the PMT digitization.
+// Signals are convoluted in direct form by the vectorized
+// ATLTileCalTBPulseKernel. Without SIMD support, long signals use an FFT
+// instead: the spectrum of ATLTileCalTBConstants::pmt_response is computed
+// once per instance (one instance per thread, owned by the event action),
+// then both PMT signals of a cell are convoluted with a single complex FFT
+// (up in the real part, down in the imaginary part).
+// Hits stored in the sparse layout (ATLTileCalTB_SparseHits) are
+// convoluted by adding a scaled copy of the response for each bin
+// with a signal.
+// The signals have the bins of Binning (ATLTileCalTBBinning), the pulses
+// its frames. Only the binnings of ATLTileCalTBBinnings::List are
+// instantiated (in ATLTileCalTBDigitizer.cc).
+
+#ifndef ATLTileCalTBDigitizer_h
+#define ATLTileCalTBDigitizer_h 1
+
+//Includers from project files
+//
+#include "ATLTileCalTBConstants.hh"
+#include "ATLTileCalTBHit.hh"
+#include "ATLTileCalTBPulseKernel.hh"
+#include "ATLTileCalTBTimeBinning.hh"
+#include "ATLTileCalTBVDigitizer.hh"
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+
+//Includers from C++
+//
+#include <array>
+#include <complex>
+#include <vector>
+
+template <class Binning>
+class ATLTileCalTBDigitizer : public ATLTileCalTBVDigitizer {
+
+    static_assert(Binning::windowFrames > fOFLastFrame, "Time window ends before the last optimal filtering sample");
+
+    public:
+        using Pulse = std::array<G4double, Binning::windowFrames>;
+        //Binned signal as stored in the hits (single precision with ATLTileCalTB_CompactHits)
+        using Value = ATLTileCalTBHit::SdepValue;
+        using Signal = ATLTileCalTBHit::SdepArray<Binning>;
+        using Kernel = ATLTileCalTBPulseKernel<Binning, ATLTileCalTBConstants::pmt_response.size()>;
+
+        ATLTileCalTBDigitizer();
+        virtual ~ATLTileCalTBDigitizer();
+
+        //Methods from base class
+        //
+        virtual void DigitizeMax( const ATLTileCalTBHit& hit, G4double& maxUp, G4double& maxDown ) const override;
+        virtual void DigitizePulses( const ATLTileCalTBHit& hit, std::vector<G4double>& pulseUp,
+                                     std::vector<G4double>& pulseDown, G4double& maxUp, G4double& maxDown ) const override;
+        virtual void Sample( const ATLTileCalTBHit& hit, Samples& samplesUp, Samples& samplesDown ) const override;
+        #ifndef ATLTileCalTB_SparseHits
+        virtual std::size_t AddToBatch( const ATLTileCalTBHit& hit ) override;
+        #endif
+        virtual void ConvoluteBatch() override;
+        virtual G4double GetBatchMax( std::size_t channel ) const override { return fBatchMax[channel]; }
+        virtual void ClearBatch() override;
+        virtual void Benchmark( std::size_t nPulses = 1000 ) const override;
+
+        //Convolute the up and down PMT signals with the PMT response,
+        //the signals are zero outside of [firstBin, lastBin]
+        void ConvolutePMT( const Value* sdepUp, const Value* sdepDown,
+                           std::size_t firstBin, std::size_t lastBin,
+                           Pulse& pulseUp, Pulse& pulseDown ) const;
+
+        //Same as ConvolutePMT() but only return the maximum of each pulse
+        void ConvolutePMTMax( const Value* sdepUp, const Value* sdepDown,
+                              std::size_t firstBin, std::size_t lastBin,
+                              G4double& maxUp, G4double& maxDown ) const;
+
+        //Convolute a sparse signal, cost scales with the number of entries
+        static void ConvolutePMTSparse( const std::vector<ATLTileCalTBHit::SdepEntry>& sdep,
+                                        Pulse& pulseUp, Pulse& pulseDown );
+
+        //Batched digitization: channels (PMT signals) of one or more events are
+        //stacked and convoluted together as a banded Toeplitz matrix product,
+        //AddToBatch() returns the channel index to read back with GetBatchMax()
+        std::size_t AddToBatch( const Value* sdep, std::size_t firstBin, std::size_t lastBin );
+        std::size_t GetBatchSize() const { return fBatchFirst.size(); }
+
+        //Signals evaluated only at the sampling frames of the optimal filtering
+        void SamplePMT( const Value* sdepUp, const Value* sdepDown,
+                        std::size_t firstBin, std::size_t lastBin,
+                        Samples& samplesUp, Samples& samplesDown ) const;
+        void SamplePMTSparse( const std::vector<ATLTileCalTBHit::SdepEntry>& sdep,
+                              Samples& samplesUp, Samples& samplesDown ) const;
+
+        //Reference direct-form convolution, O(bins x pmt_response)
+        static void ConvolutePMTDirect( const Value* sdep, Pulse& pulse );
+
+    private:
+        //Smallest power of two avoiding circular aliasing in the first frames
+        static constexpr std::size_t fFFTSize = [](){
+            std::size_t size = 1;
+            while ( size < Binning::windowFrames + ATLTileCalTBConstants::pmt_response.size() - 1 ) size *= 2;
+            return size;
+        }();
+
+        //Largest deviation of the kernels from the direct convolution
+        //allowed by the benchmark, relative to the largest pulse
+        static constexpr G4double fBenchmarkTolerance = 1.e-10;
+
+        //Without SIMD, signals spanning up to this many bins are convoluted
+        //directly, longer ones with the FFT (break-even of the two kernels)
+        static constexpr std::size_t fDirectMaxSpan = 128;
+
+        //Tile of the batched product: fBatchRows output frames by
+        //fBatchChannels channels are accumulated at once
+        static constexpr std::size_t fBatchRows = 4;
+        static constexpr std::size_t fBatchChannels = 16;
+
+        G4bool UseKernel( std::size_t firstBin, std::size_t lastBin ) const;
+        void FFT( std::vector<std::complex<G4double>>& data, G4bool inverse ) const;
+        void ConvolutePMTFFT( const Value* sdepUp, const Value* sdepDown,
+                              std::size_t firstBin, std::size_t lastBin,
+                              Pulse& pulseUp, Pulse& pulseDown ) const;
+
+        //Channels are sorted by bin range so that a tile spans few bins
+        void ConvoluteBatchTile( const std::size_t* channels, std::size_t nChannels );
+
+        //Accumulate bins [nmin, nmax] of the panel into output frames
+        //[k0, k0 + fBatchRows), one variant per instruction set
+        using BatchBlock = G4double[fBatchRows][fBatchChannels];
+        void AccumulateBlock( std::size_t k0, std::size_t nmin, std::size_t nmax, BatchBlock& acc ) const;
+        #ifdef ATLTileCalTB_X86KERNELS
+        __attribute__((target("avx2,fma")))
+        void AccumulateBlockAVX2( std::size_t k0, std::size_t nmin, std::size_t nmax, BatchBlock& acc ) const;
+        __attribute__((target("avx512f")))
+        void AccumulateBlockAVX512( std::size_t k0, std::size_t nmin, std::size_t nmax, BatchBlock& acc ) const;
+        #endif
+        //Response from output frame k0 - (frame of bin n), zero outside of the response
+        const G4double* BatchResponse( std::size_t k0, std::size_t n ) const {
+            return fPaddedResponse.data() + fBatchRows - 1 + k0 - Binning::GetFrame(n);
+        }
+
+        Kernel fKernel;
+
+        std::vector<std::complex<G4double>> fResponseSpectrum;
+        std::vector<std::complex<G4double>> fTwiddles;
+        std::vector<std::size_t> fBitReverse;
+        mutable std::vector<std::complex<G4double>> fWorkspace;
+
+        //Stacked signals (bins in range of each channel, starting at
+        //fBatchOffset), their bin ranges and pulse maxima, and the
+        //bin-major panel of a tile
+        std::vector<G4double> fBatchSdep;
+        std::vector<std::size_t> fBatchOffset;
+        std::vector<std::size_t> fBatchFirst;
+        std::vector<std::size_t> fBatchLast;
+        std::vector<G4double> fBatchMax;
+        std::vector<std::size_t> fBatchOrder;
+        std::vector<G4double> fBatchPanel;
+        std::array<G4double, ATLTileCalTBConstants::pmt_response.size() + 2 * (fBatchRows - 1)> fPaddedResponse;
+
+};
+
+extern template class ATLTileCalTBDigitizer<ATLTileCalTBBinnings::Window350>;
+extern template class ATLTileCalTBDigitizer<ATLTileCalTBBinnings::Window200>;
+extern template class ATLTileCalTBDigitizer<ATLTileCalTBBinnings::Window350Tail5>;
+extern template class ATLTileCalTBDigitizer<ATLTileCalTBBinnings::Window200Tail5>;
+
+#endif //ATLTileCalTBDigitizer_h
+
+//**************************************************
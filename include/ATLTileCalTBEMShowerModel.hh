@@ -0,0 +1,77 @@
+//**************************************************
+// \file ATLTileCalTBEMShowerModel.hh
+// \brief: definition of ATLTileCalTBEMShowerModel
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Fast simulation of the EM showers in the Tile modules. An e+, e- or
+// gamma above the energy threshold is killed and its energy is split in
+// spots, sampled from the GFlash longitudinal (Grindhammer and Peters,
+// sampling calorimeter) and radial (core and tail) profiles of the
+// effective medium of ATLTileCalTBEMShowerParameters. The longitudinal
+// profile of each shower is drawn from the correlated fluctuations of its
+// depth and shape. The spots landing in a scintillator are passed to the
+// sensitive detector as G4FastHit.
+
+#ifdef ATLTileCalTB_FastSim
+
+#ifndef ATLTileCalTBEMShowerModel_h
+#define ATLTileCalTBEMShowerModel_h 1
+
+//Includers from Geant4
+//
+#include "G4VFastSimulationModel.hh"
+
+//Forward declaration from project files
+//
+class ATLTileCalTBEMShowerParameters;
+
+//Forward declaration from Geant4
+//
+class G4FastSimHitMaker;
+
+class ATLTileCalTBEMShowerModel : public G4VFastSimulationModel {
+
+    public:
+        ATLTileCalTBEMShowerModel( const G4String& name );
+        virtual ~ATLTileCalTBEMShowerModel();
+
+        //Methods from base class
+        //
+        virtual G4bool IsApplicable( const G4ParticleDefinition& particle );
+        virtual G4bool ModelTrigger( const G4FastTrack& fastTrack );
+        virtual void DoIt( const G4FastTrack& fastTrack, G4FastStep& fastStep );
+
+    private:
+        //Longitudinal profile in units of X0: Gamma distribution with
+        //shape alpha and rate beta, peaking at T
+        struct LongitudinalProfile {
+            G4double alpha;
+            G4double beta;
+            G4double T;
+        };
+
+        //Average (log) depth and shape of the showers and their
+        //fluctuations, false outside of the parameterization
+        struct ProfileDistribution {
+            G4double lnT;
+            G4double lnAlpha;
+            G4double sigmaLnT;
+            G4double sigmaLnAlpha;
+            G4double correlation;
+        };
+        G4bool GetProfileDistribution( G4double energy, G4bool isGamma, ProfileDistribution& distribution ) const;
+        LongitudinalProfile SampleLongitudinalProfile( const ProfileDistribution& distribution ) const;
+
+        const ATLTileCalTBEMShowerParameters* fParameters;
+        G4FastSimHitMaker* fHitMaker;
+
+};
+
+#endif //ATLTileCalTBEMShowerModel_h
+#endif //ATLTileCalTB_FastSim
+
+//**************************************************
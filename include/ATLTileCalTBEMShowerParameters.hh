@@ -0,0 +1,92 @@
+//**************************************************
+// \file ATLTileCalTBEMShowerParameters.hh
+// \brief: definition of ATLTileCalTBEMShowerParameters
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Parameters of the EM shower fast simulation (ATLTileCalTBEMShowerModel).
+// The Tile modules are described as the effective sampling medium of their
+// periods (GFlash, Grindhammer and Peters): radiation length, Moliere
+// radius, critical energy, effective Z, sampling frequency and e/mip are
+// computed from the materials and volumes of the periods in the geometry,
+// the scintillator weight from the sampling fraction of the photoelectron
+// calibration. The response scale is the residual correction tuned against
+// the full simulation (fastsim_comparison.mac and FastSimComparison.C).
+// Configured with the /ATLTileCalTB/fastsim/ commands and shared by all
+// threads.
+
+#ifdef ATLTileCalTB_FastSim
+
+#ifndef ATLTileCalTBEMShowerParameters_h
+#define ATLTileCalTBEMShowerParameters_h 1
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+#include "G4GenericMessenger.hh"
+
+class ATLTileCalTBEMShowerParameters {
+
+    public:
+        static ATLTileCalTBEMShowerParameters* GetInstance();
+
+        //Compute the effective medium once the geometry is built
+        //(master thread, before the first event)
+        void Update();
+
+        //The model only triggers if enabled and the medium is known
+        G4bool IsEnabled() const { return fEnabled && fValid; }
+        G4double GetMinEnergy() const { return fMinEnergy; }
+        G4double GetSpotEnergy() const { return fSpotEnergy; }
+        G4bool HasFluctuations() const { return fFluctuations; }
+
+        G4double GetRadiationLength() const { return fRadiationLength; }
+        G4double GetMoliereRadius() const { return fMoliereRadius; }
+        G4double GetCriticalEnergy() const { return fCriticalEnergy; }
+        G4double GetEffectiveZ() const { return fEffectiveZ; }
+        //Radiation lengths per sampling period
+        G4double GetSamplingFrequency() const { return fSamplingFrequency; }
+        //Visible energy of an electron over the one of a mip
+        G4double GetEHat() const { return fEHat; }
+        //Weight of the energy of the spots landing in a scintillator:
+        //sampling fraction of the showers over the scintillator volume
+        //fraction, times the response scale
+        G4double GetScintillatorWeight() const { return fScintillatorWeight * fResponseScale; }
+
+        void Print() const;
+
+    private:
+        ATLTileCalTBEMShowerParameters();
+        ~ATLTileCalTBEMShowerParameters();
+
+        G4bool fEnabled;
+        G4double fMinEnergy;
+        G4double fSpotEnergy;
+        G4bool fFluctuations;
+        G4double fResponseScale;
+
+        G4bool fUpdated;
+        G4bool fValid;
+        G4double fRadiationLength;
+        G4double fMoliereRadius;
+        G4double fCriticalEnergy;
+        G4double fEffectiveZ;
+        G4double fSamplingFrequency;
+        G4double fEHat;
+        G4double fScintillatorWeight;
+
+        G4GenericMessenger* fMessenger;
+
+    public:
+        ATLTileCalTBEMShowerParameters(ATLTileCalTBEMShowerParameters const&) = delete;
+        void operator=(ATLTileCalTBEMShowerParameters const&) = delete;
+
+};
+
+#endif //ATLTileCalTBEMShowerParameters_h
+#endif //ATLTileCalTB_FastSim
+
+//**************************************************
@@ -14,52 +14,112 @@
 //
 #include "G4UserEventAction.hh"
 #include "G4Types.hh"
+#include "G4GenericMessenger.hh"
+#include "G4Accumulable.hh"
 
 //Includers from project files
 //
 #include "ATLTileCalTBHit.hh"
+#include "ATLTileCalTBVDigitizer.hh"
+#include "ATLTileCalTBEventInformation.hh"
 
 //Includers from C++
 //
 #include <array>
+#include <memory>
 #include <vector>
+#include <chrono>
 #ifdef ATLTileCalTB_PulseOutput
 #include <filesystem>
 #endif
 
-//Forward declaration from project
-//
-class ATLTileCalTBPrimaryGenAction;
-
-constexpr std::size_t nAuxData = 2; //0->Leakage, 1->Energy Deposited in Calo
-
 class ATLTileCalTBEventAction : public G4UserEventAction {
     
     public:
-        ATLTileCalTBEventAction(ATLTileCalTBPrimaryGenAction* pga);
+        ATLTileCalTBEventAction();
         virtual ~ATLTileCalTBEventAction();
 
         virtual void BeginOfEventAction( const G4Event* event );
         virtual void EndOfEventAction( const G4Event* event );
+        #ifdef ATLTileCalTB_SubEvent
+        //Add the hits and deposits of a sub-event to the event that spawned it
+        virtual void MergeSubEvent( G4Event* masterEvent, const G4Event* subEvent );
+        #endif
 
         void Add( std::size_t index, G4double de );
 
         std::vector<G4double>& GetEdepVector() { return fEdepVector; };
         std::vector<G4double>& GetSdepVector() { return fSdepVector; };
+        std::vector<G4double>& GetPhaseVector() { return fPhaseVector; };
+
+        //Digitize the events buffered by the batched mode and fill their
+        //ntuple rows, to be called before writing the output at end of run
+        void FlushDigitization();
+
+        //Time at which the last event of the thread was transported
+        std::chrono::steady_clock::time_point GetLastEventEnd() const { return fLastEventEnd; };
+
+        //Events written in the run, without the empty events of other
+        //shards or ranks and the sub-events (merged at end of run)
+        G4int GetNoOfSimulatedEvents() const { return fSimulatedEvents.GetValue(); };
 
     private:
+        //Signal reconstruction, resolved from the command string once
+        enum class Reconstruction { Peak, OptimalFiltering };
+
+        //Setters used by the messenger
+        void SetReconstruction( const G4String& mode );
+        void SetBatchedDigi( G4bool batched );
+
         ATLTileCalTBHitsCollection* GetHitsCollection(G4int hcID, const G4Event* event) const;
-        ATLTileCalTBPrimaryGenAction* fPrimaryGenAction;
+        #ifdef ATLTileCalTB_SubEvent
+        //Information of the event or sub-event being tracked by the thread
+        static ATLTileCalTBEventInformation* GetCurrentEventInformation();
+        #endif
+        void FillNtuple( const std::array<G4double, nAuxData>& aux, G4int pdgID, G4double eBeam, G4int eventID );
+        static G4double ApplyNoise( G4double sdep_up, G4double sdep_down, G4double noise_up, G4double noise_down );
+        void BufferEvent( const ATLTileCalTBHitsCollection* HC, const ATLTileCalTBEventInformation& information );
+        //Digitizer of the binning selected at initialization
+        ATLTileCalTBVDigitizer& GetDigitizer();
+
+        //Event waiting for the batched digitization, the noise is drawn
+        //when the event is buffered to keep the random sequence unchanged
+        struct BufferedEvent {
+            std::array<G4double, nAuxData> aux;
+            std::vector<G4double> edep;
+            std::vector<std::size_t> channel; //batch channel of the up PMT (down is next), SIZE_MAX if empty
+            std::vector<G4double> noise; //up and down noise of each cell
+            G4int pdgID;
+            G4double eBeam;
+            G4int eventID;
+        };
+
         std::size_t fNoOfCells;
         std::array<G4double, nAuxData> fAux;
         std::vector<G4double> fEdepVector;
         std::vector<G4double> fSdepVector;
+        std::vector<G4double> fPhaseVector;
+        //Digitizer of the selected binning, created at the first event
+        std::unique_ptr<ATLTileCalTBVDigitizer> fDigitizer;
+        G4GenericMessenger* fMessenger;
+        Reconstruction fReconstruction;
+        G4bool fBatchedDigi;
+        G4int fDigiBatchEvents;
+        std::vector<BufferedEvent> fBufferedEvents;
+        G4bool fPhaseWritten; //fPhaseVector holds optimal filtering phases
+        std::chrono::steady_clock::time_point fLastEventEnd;
+        G4Accumulable<G4int> fSimulatedEvents;
         #ifdef ATLTileCalTB_PulseOutput
         std::filesystem::path pulse_event_path;
         #endif
 };
                      
+#ifdef ATLTileCalTB_SubEvent
+//Deposits go to the event or sub-event, which can end on another thread
+inline void ATLTileCalTBEventAction::Add( std::size_t index, G4double de ) { GetCurrentEventInformation()->Add(index, de); }
+#else
 inline void ATLTileCalTBEventAction::Add( std::size_t index, G4double de ) { fAux[index] += de; }
+#endif
 
 #endif //ATLTileCalTBEventAction_h
 
@@ -0,0 +1,69 @@
+//**************************************************
+// \file ATLTileCalTBEventInformation.hh
+// \brief: definition of ATLTileCalTBEventInformation
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// User information of an event, attached by the primary generator to the
+// events it simulates (shards and MPI ranks leave the other events empty):
+// the ID of the event in the run and its primary particle. In sub-event
+// parallel mode the event can end on another thread than the one that
+// generated it, so the leakage and calorimeter deposits are accumulated
+// here and the ones of the sub-events are merged into the event that
+// spawned them.
+
+#ifndef ATLTileCalTBEventInformation_h
+#define ATLTileCalTBEventInformation_h 1
+
+//Includers from Geant4
+//
+#include "G4VUserEventInformation.hh"
+#include "G4Types.hh"
+
+//Includers from C++
+//
+#include <array>
+
+constexpr std::size_t nAuxData = 2; //0->Leakage, 1->Energy Deposited in Calo
+
+class ATLTileCalTBEventInformation : public G4VUserEventInformation {
+
+    public:
+        //Event ID of the run, -1 for sub-events
+        ATLTileCalTBEventInformation( G4int eventID, G4int pdgID, G4double eBeam );
+        virtual ~ATLTileCalTBEventInformation() = default;
+
+        //Method from base class
+        //
+        virtual void Print() const;
+
+        G4int GetEventID() const { return fEventID; }
+        G4int GetPDGID() const { return fPDGID; }
+        G4double GetEBeam() const { return fEBeam; }
+
+        #ifdef ATLTileCalTB_SubEvent
+        void Add( std::size_t index, G4double de ) { fAux[index] += de; }
+        const std::array<G4double, nAuxData>& GetAux() const { return fAux; }
+        void Merge( const ATLTileCalTBEventInformation& subEvent );
+        //The end of event can be seen by more than one thread
+        G4bool IsWritten() const { return fWritten; }
+        void SetWritten() { fWritten = true; }
+        #endif
+
+    private:
+        G4int fEventID;
+        G4int fPDGID;
+        G4double fEBeam;
+        #ifdef ATLTileCalTB_SubEvent
+        std::array<G4double, nAuxData> fAux;
+        G4bool fWritten;
+        #endif
+
+};
+
+#endif //ATLTileCalTBEventInformation_h
+
+//**************************************************
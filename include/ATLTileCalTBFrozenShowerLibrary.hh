@@ -0,0 +1,168 @@
+//**************************************************
+// \file ATLTileCalTBFrozenShowerLibrary.hh
+// \brief: definition of ATLTileCalTBFrozenShowerLibrary
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Library of low-energy EM showers recorded in the Tile periods
+// (frozen showers). A shower is the list of scintillator deposits
+// (after Birks' law) of an e+, e- or gamma, in the local frame of the
+// period it entered and relative to its entry point. It is stored in the
+// slot of its energy bin, angle bin (direction along the period axis) and
+// tile row (scintillator copy number of the period), with the phase of
+// the entry point in the 18 mm period and the azimuth of the direction
+// around the period axis, to be replayed at the same phase.
+//
+// The library file is a header, the slot index, the showers and their
+// spots as fixed-size records in the byte order of the machine that
+// wrote it, which is checked with a marker of the header. It is
+// memory-mapped read-only, validated once and shared by all threads.
+// In generation mode the showers recorded by the workers are collected
+// here and written by the master at the end of each run. Configured with
+// the /ATLTileCalTB/frozen/ commands.
+
+#ifdef ATLTileCalTB_FastSim
+
+#ifndef ATLTileCalTBFrozenShowerLibrary_h
+#define ATLTileCalTBFrozenShowerLibrary_h 1
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+#include "G4AffineTransform.hh"
+#include "G4GenericMessenger.hh"
+#include "G4Threading.hh"
+#include "G4ThreeVector.hh"
+
+//Includers from C++
+//
+#include <cstdint>
+#include <vector>
+
+class ATLTileCalTBFrozenShowerLibrary {
+
+    public:
+        static ATLTileCalTBFrozenShowerLibrary* GetInstance();
+
+        //Records of the library file
+        //
+        struct Header {
+            char magic[8];
+            std::uint32_t byteOrder; //fByteOrder as written
+            std::uint32_t noOfRows;
+            std::uint32_t noOfEnergyBins;
+            std::uint32_t noOfAngleBins; //uniform in cos(theta) from -1 to 1
+            G4double minEnergy; //MeV, energy bins are logarithmic
+            G4double maxEnergy;
+            std::uint64_t noOfShowers;
+            std::uint64_t noOfSpots;
+        };
+        //Showers of an (energy bin, angle bin, row) slot,
+        //index = (energy bin * noOfAngleBins + angle bin) * noOfRows + row
+        struct Slot {
+            std::uint64_t firstShower;
+            std::uint64_t noOfShowers;
+        };
+        struct Shower {
+            std::uint64_t firstSpot;
+            std::uint32_t noOfSpots;
+            float energy; //MeV, kinetic energy of the particle
+            float phase; //mm, entry point along the period axis
+            float azimuth; //rad, direction around the period axis
+        };
+        //Position from the entry point along the period axis and the two
+        //other local axes (mm), fraction of the particle energy
+        struct Spot {
+            float axial;
+            float lateral1;
+            float lateral2;
+            float energyFraction;
+        };
+
+        //Entry of a particle in a period, local axes in the order
+        //axis, axis + 1, axis + 2 (modulo 3)
+        struct Entry {
+            G4AffineTransform toLocal;
+            std::size_t axis;
+            G4ThreeVector position; //local
+            G4double phase; //position along the axis from the period edge
+            G4double cosTheta; //direction along the axis
+            G4double azimuth; //direction around the axis
+            G4int row;
+        };
+
+        static constexpr std::size_t fNoOfRows = 11;
+        static constexpr std::uint32_t fByteOrder = 0x01020304;
+
+        //Fast simulation from a loaded library
+        //
+        G4bool IsLoaded() const { return fHeader != nullptr; }
+        //Random shower of the slot of the energy, direction and row of
+        //an entry, nullptr if outside of the library or the slot is empty
+        const Shower* Lookup( G4double energy, const Entry& entry ) const;
+        const Spot* GetSpots( const Shower* shower ) const { return fSpots + shower->firstSpot; }
+
+        //Generation of a library
+        //
+        G4bool IsGenerating() const { return !fOutputFileName.empty(); }
+        G4bool InGenerationRange( G4double energy ) const;
+        //Thread-safe, called by the workers at the end of each event
+        void AddShower( G4double energy, const Entry& entry, const std::vector<Spot>& spots );
+        //Write the showers generated so far, called by the master
+        void Write() const;
+
+        void Print() const;
+
+    private:
+        ATLTileCalTBFrozenShowerLibrary();
+        ~ATLTileCalTBFrozenShowerLibrary();
+
+        //Setters used by the messenger
+        void Load( const G4String& fileName );
+        void SetOutputFileName( const G4String& fileName );
+        void Unload();
+
+        //Energy bin in [0, noOfEnergyBins), -1 if outside of the range
+        static G4int GetEnergyBin( G4double energy, G4double minEnergy, G4double maxEnergy, G4int noOfEnergyBins );
+        static G4int GetAngleBin( G4double cosTheta, G4int noOfAngleBins );
+
+        //Memory-mapped library
+        G4String fFileName;
+        void* fData;
+        std::size_t fDataSize;
+        const Header* fHeader;
+        const Slot* fSlots;
+        const Shower* fShowers;
+        const Spot* fSpots;
+
+        //Generation
+        struct GeneratedShower {
+            float energy;
+            float phase;
+            float azimuth;
+            std::vector<Spot> spots;
+        };
+        G4String fOutputFileName;
+        G4double fMinEnergy;
+        G4double fMaxEnergy;
+        G4int fNoOfEnergyBins;
+        G4int fNoOfAngleBins;
+        G4int fMaxShowersPerSlot;
+        std::vector<std::vector<GeneratedShower>> fGeneratedShowers; //per slot
+        mutable G4Mutex fMutex;
+
+        G4GenericMessenger* fMessenger;
+
+    public:
+        ATLTileCalTBFrozenShowerLibrary(ATLTileCalTBFrozenShowerLibrary const&) = delete;
+        void operator=(ATLTileCalTBFrozenShowerLibrary const&) = delete;
+
+};
+
+#endif //ATLTileCalTBFrozenShowerLibrary_h
+#endif //ATLTileCalTB_FastSim
+
+//**************************************************
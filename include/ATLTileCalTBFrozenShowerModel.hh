@@ -0,0 +1,82 @@
+//**************************************************
+// \file ATLTileCalTBFrozenShowerModel.hh
+// \brief: definition of ATLTileCalTBFrozenShowerModel
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Fast simulation of the low-energy EM showers in the Tile periods with
+// ATLTileCalTBFrozenShowerLibrary. An e+, e- or gamma in a period is
+// replaced by a library shower of its energy bin, angle bin and tile row.
+// The shower is moved along the period axis to the phase it was recorded
+// at, so that its deposits land in the scintillators as in the full
+// simulation, and turned around the axis to the azimuth of the particle.
+// The row is the copy number of the scintillator of the period closest to
+// the particle. In generation mode the model only starts the recording of
+// the primary particle shower.
+
+#ifdef ATLTileCalTB_FastSim
+
+#ifndef ATLTileCalTBFrozenShowerModel_h
+#define ATLTileCalTBFrozenShowerModel_h 1
+
+//Includers from project files
+//
+#include "ATLTileCalTBFrozenShowerLibrary.hh"
+
+//Includers from Geant4
+//
+#include "G4VFastSimulationModel.hh"
+
+//Includers from C++
+//
+#include <utility>
+#include <vector>
+
+//Forward declaration from Geant4
+//
+class G4FastSimHitMaker;
+class G4LogicalVolume;
+class G4Track;
+
+class ATLTileCalTBFrozenShowerModel : public G4VFastSimulationModel {
+
+    public:
+        ATLTileCalTBFrozenShowerModel( const G4String& name );
+        virtual ~ATLTileCalTBFrozenShowerModel();
+
+        //Methods from base class
+        //
+        virtual G4bool IsApplicable( const G4ParticleDefinition& particle );
+        virtual G4bool ModelTrigger( const G4FastTrack& fastTrack );
+        virtual void DoIt( const G4FastTrack& fastTrack, G4FastStep& fastStep );
+
+    private:
+        //Entry of a track in a period, false if not found
+        G4bool FindEntry( const G4Track* track, ATLTileCalTBFrozenShowerLibrary::Entry& entry ) const;
+
+        //Period logical volume: axis of the periodicity (thinnest extent)
+        //and its lower edge, position along the radial axis (z) of each
+        //scintillator and its copy number
+        struct Period {
+            const G4LogicalVolume* logical;
+            std::size_t axis;
+            G4double axisMin;
+            std::vector<std::pair<G4double, G4int>> rows;
+        };
+        std::vector<Period> fPeriods;
+
+        const ATLTileCalTBFrozenShowerLibrary* fLibrary;
+        //Chosen by ModelTrigger()
+        const ATLTileCalTBFrozenShowerLibrary::Shower* fShower;
+        ATLTileCalTBFrozenShowerLibrary::Entry fEntry;
+        G4FastSimHitMaker* fHitMaker;
+
+};
+
+#endif //ATLTileCalTBFrozenShowerModel_h
+#endif //ATLTileCalTB_FastSim
+
+//**************************************************
@@ -0,0 +1,72 @@
+//**************************************************
+// \file ATLTileCalTBFrozenShowerRecorder.hh
+// \brief: definition of ATLTileCalTBFrozenShowerRecorder
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Recorder of the frozen shower of an event in generation mode, one per
+// thread. The shower starts when the frozen shower model sees the primary
+// particle entering a Tile period, the sensitive detector then records all
+// the scintillator deposits of the event in the local frame of that period
+// and the shower is added to ATLTileCalTBFrozenShowerLibrary at the end of
+// the event.
+
+#ifdef ATLTileCalTB_FastSim
+
+#ifndef ATLTileCalTBFrozenShowerRecorder_h
+#define ATLTileCalTBFrozenShowerRecorder_h 1
+
+//Includers from project files
+//
+#include "ATLTileCalTBFrozenShowerLibrary.hh"
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+#include "G4ThreeVector.hh"
+#include "G4ThreadLocalSingleton.hh"
+
+//Includers from C++
+//
+#include <vector>
+
+class ATLTileCalTBFrozenShowerRecorder {
+    friend class G4ThreadLocalSingleton<ATLTileCalTBFrozenShowerRecorder>;
+
+    public:
+        // Returns pointer to Singleton
+        static ATLTileCalTBFrozenShowerRecorder* GetInstance() {
+            static G4ThreadLocalSingleton<ATLTileCalTBFrozenShowerRecorder> instance {};
+            return instance.Instance();
+        }
+
+        void Start( const ATLTileCalTBFrozenShowerLibrary::Entry& entry, G4double energy );
+        G4bool IsStarted() const { return fStarted; }
+        //Deposit after Birks' law, ignored before the start
+        void Record( const G4ThreeVector& position, G4double energy );
+        //Add the shower to the library and reset
+        void EndOfEvent();
+        void Reset();
+
+    private:
+        ATLTileCalTBFrozenShowerRecorder();
+        ~ATLTileCalTBFrozenShowerRecorder() = default;
+
+        G4bool fStarted;
+        ATLTileCalTBFrozenShowerLibrary::Entry fEntry;
+        G4double fEnergy;
+        std::vector<ATLTileCalTBFrozenShowerLibrary::Spot> fSpots;
+
+    public:
+        ATLTileCalTBFrozenShowerRecorder(ATLTileCalTBFrozenShowerRecorder const&) = delete;
+        void operator=(ATLTileCalTBFrozenShowerRecorder const&) = delete;
+
+};
+
+#endif //ATLTileCalTBFrozenShowerRecorder_h
+#endif //ATLTileCalTB_FastSim
+
+//**************************************************
@@ -13,11 +13,14 @@
 //Includers from Geant4
 //
 #include "G4ThreadLocalSingleton.hh"
+#include "G4LogicalVolume.hh"
 
 //Includers from C++
 //
 #include <array>
+#include <cstdint>
 #include <ostream>
+#include <vector>
 
 
 namespace ATLTileCalTBGeometry {
@@ -198,11 +201,75 @@ namespace ATLTileCalTBGeometry {
                 Cell(Module::EXTENDED_D4,  Row::D,   4,  4,  5, 17, 17,  0,  0,  0,  0), // 103
             };
 
+            // Cell index of each module parsable with row and tile indices
+            // (lower long, upper long and extended), row index and tile index,
+            // generated at compile time from fCellVector (fInvalidCell if none)
+            static constexpr std::size_t fNoOfTableModules = 3;
+            static constexpr std::size_t fNoOfRows = 11;
+            static constexpr std::size_t fMaxPeriods = 320;
+            static constexpr std::uint8_t fInvalidCell = UINT8_MAX;
+            using CellTable = std::array<std::array<std::array<std::uint8_t, fMaxPeriods>, fNoOfRows>, fNoOfTableModules>;
+            static const CellTable fCellTable;
+
+            // Helpers to build and check fCellTable (defined in the source file)
+            static constexpr std::size_t FirstCellOfRow(Module module, std::size_t rowIdx);
+            static constexpr std::size_t NumberOfPeriods(Module module, std::size_t rowIdx);
+            static constexpr std::size_t ScanCellIndex(Module module, std::size_t rowIdx, std::size_t tileIdx);
+            static constexpr CellTable BuildCellTable();
+            static constexpr bool CheckCellTable(Module module);
+
         public:
             CellLUT(CellLUT const&) = delete;
             void operator=(CellLUT const&) = delete;
     };
 
+
+    // Roles of the logical volumes as bit flags
+    enum class VolumeRole : std::uint8_t {
+        None         = 0,
+        CaloEnvelope = 1 << 0, // CALO::CALO
+        Barrel       = 1 << 1, // Tile::Barrel
+        Absorber     = 1 << 2, // Tile::Absorber
+        Scintillator = 1 << 3, // Tile::Scintillator
+        GirderFinger = 1 << 4, // Tile::GirderMother, Tile::Finger, Tile::EFinger
+        Beamline     = 1 << 5, // BEAMPIPE1, BEAMPIPE2, S1, S2, S3
+        Module       = 1 << 6, // Tile::BarrelModule, Tile::EBarrelModule, Tile::ITCModule, Tile::Plug1Module, Tile::Plug2Module
+        Period       = 1 << 7, // Tile::Period
+    };
+    constexpr VolumeRole operator|(VolumeRole lhs, VolumeRole rhs) {
+        return static_cast<VolumeRole>(static_cast<std::uint8_t>(lhs) | static_cast<std::uint8_t>(rhs));
+    }
+
+    // Roles of all the logical volumes indexed by their instance ID, resolved
+    // once from the volume names when the geometry is built. The table is
+    // shared by all threads and read-only after Build().
+    class VolumeRoleTable {
+        public:
+            // Returns pointer to Singleton
+            static VolumeRoleTable* GetInstance() {
+                static VolumeRoleTable instance {};
+                return &instance;
+            }
+
+            // Fill the table from the logical volume store
+            void Build();
+
+            // True if the volume has at least one of the roles
+            G4bool HasAnyRole(const G4LogicalVolume* volume, VolumeRole roles) const {
+                const auto id = static_cast<std::size_t>(volume->GetInstanceID());
+                return id < fRoles.size() && (fRoles[id] & static_cast<std::uint8_t>(roles)) != 0;
+            }
+
+        private:
+            VolumeRoleTable() = default;
+            ~VolumeRoleTable() = default;
+
+            std::vector<std::uint8_t> fRoles;
+
+        public:
+            VolumeRoleTable(VolumeRoleTable const&) = delete;
+            void operator=(VolumeRoleTable const&) = delete;
+    };
 }
 
 #endif //ATLTileCalTBGeometry_h
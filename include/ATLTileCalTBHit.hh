@@ -17,18 +17,69 @@
 //
 #include "G4VHit.hh"
 #include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
 
 //Includers from C++
 //
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ATLTileCalTBSignalBuffer;
 
 class ATLTileCalTBHit : public G4VHit {
   
     public:
+        //Precision of the stored signal, photoelectrons scaled by the U-shape
+        //are accumulated in single precision with ATLTileCalTB_CompactHits
+        #ifdef ATLTileCalTB_CompactHits
+        using SdepValue = float;
+        #else
+        using SdepValue = G4double;
+        #endif
+        //Signal of a PMT binned with a binning of ATLTileCalTBBinnings,
+        //the hits store the bins of the binning selected at startup
+        template <class Binning>
+        using SdepArray = std::array<SdepValue, Binning::bins>;
+
+        //Signal deposited in a single bin (sparse layout)
+        struct SdepEntry {
+            std::uint32_t frame;
+            SdepValue up;
+            SdepValue down;
+        };
+
+        #ifdef ATLTileCalTB_DeferredPoisson
+        //Expected photoelectrons of the deposits in a frame with the same
+        //U-shape response (the profiles are binned)
+        struct ExpectedPe {
+            std::uint32_t frame;
+            G4double uShapeUp;
+            G4double uShapeDown;
+            G4double lambda;
+        };
+        #endif
+
+        #ifdef ATLTileCalTB_SparseHits
         ATLTileCalTBHit();
+        #else
+        //View on the signal of a cell in the ATLTileCalTBSignalBuffer of the
+        //thread, the hit zeroes the frames it wrote when deleted. Copies own
+        //their signal and the hits of a kept event are detached when the cell
+        //is reused
+        ATLTileCalTBHit( ATLTileCalTBSignalBuffer& buffer, std::size_t cellIndex );
+        #endif
         ATLTileCalTBHit( const ATLTileCalTBHit& );
         virtual ~ATLTileCalTBHit();
 
+        //Hits are allocated every event with a per-thread G4Allocator,
+        //in sub-event parallel mode the hits of an event can be deleted
+        //by another thread and use the default allocation
+        //
+        inline void* operator new( std::size_t );
+        inline void operator delete( void* hit );
+
         //Operators (= and ==)
         //
         const ATLTileCalTBHit& operator=( const ATLTileCalTBHit& );
@@ -48,40 +99,155 @@ class ATLTileCalTBHit : public G4VHit {
         void AddSdep( std::size_t index, G4double dSdepUp, G4double dSdepDown );
         void AddSdep( G4double time, G4double dSdepUp, G4double dSdepDown );
 
+        #ifndef ATLTileCalTB_SparseHits
+        //Copy the signal of a view in storage owned by the hit
+        void Detach();
+        #endif
+
+        #ifdef ATLTileCalTB_SparseHits
+        //Sort the entries by frame and sum the entries of the same frame,
+        //to be called at the end of the event before the digitization
+        void Coalesce();
+        #endif
+
+        #ifdef ATLTileCalTB_SubEvent
+        //Add the deposits of the same cell in a sub-event
+        void Merge( const ATLTileCalTBHit& subEventHit );
+        #endif
+
+        #ifdef ATLTileCalTB_DeferredPoisson
+        //Expected photoelectrons of a step (lambda) and its U-shape response,
+        //SamplePhotoelectrons() draws the photoelectrons of each frame and
+        //U-shape response at the end of the event and adds their signal
+        void AddExpectedPe( std::size_t index, G4double lambda, G4double uShapeUp, G4double uShapeDown );
+        void SamplePhotoelectrons();
+        #endif
+
         //Get methods
         //
         G4double GetEdep() const;
-        const std::array<G4double, ATLTileCalTBConstants::frames>& GetSdepUp() const;
-        const std::array<G4double, ATLTileCalTBConstants::frames>& GetSdepDown() const;
+        #ifdef ATLTileCalTB_SparseHits
+        const std::vector<SdepEntry>& GetSdepEntries() const;
+        #else
+        //GetNoOfBins() bins of ATLTileCalTBTimeBinning
+        const SdepValue* GetSdepUp() const;
+        const SdepValue* GetSdepDown() const;
+        #endif
+
+        //Range of bins with a signal, [first, last]
+        //
+        G4bool IsActive() const;
+        std::size_t GetFirstFrame() const;
+        std::size_t GetLastFrame() const;
 
     private:
         // Total energy deposition in the cell
         G4double fEdep;
 
-        //Vectors containing the binned signal
-        std::array<G4double, ATLTileCalTBConstants::frames> fSdepUp;
-        std::array<G4double, ATLTileCalTBConstants::frames> fSdepDown;
+        #ifdef ATLTileCalTB_SparseHits
+        //Frames with a signal, consecutive deposits in the same frame are
+        //merged on the fly and the others by Coalesce()
+        std::vector<SdepEntry> fSdepEntries;
+        #else
+        //Binned signal, stored in the ATLTileCalTBSignalBuffer (view)
+        //or in fOwned (copies and detached hits)
+        SdepValue* fSdepUp;
+        SdepValue* fSdepDown;
+        ATLTileCalTBSignalBuffer* fBuffer; //nullptr if not a view
+        std::size_t fCellIndex;
+        std::unique_ptr<SdepValue[]> fOwned;
+        #endif
+
+        #ifdef ATLTileCalTB_DeferredPoisson
+        //Expected photoelectrons, consecutive deposits with the same frame
+        //and U-shape response are merged on the fly
+        std::vector<ExpectedPe> fExpectedPe;
+        #endif
+
+        //First and last bin touched by AddSdep (first > last if none)
+        std::size_t fFirstFrame;
+        std::size_t fLastFrame;
+
+        #ifndef ATLTileCalTB_SparseHits
+        //Copy the signal bins of a hit in owned storage and release the view
+        void CopySignal( const ATLTileCalTBHit& source );
+        void ReleaseView();
+        #endif
 
 };
 
 using ATLTileCalTBHitsCollection = G4THitsCollection<ATLTileCalTBHit>;
 
+extern G4ThreadLocal G4Allocator<ATLTileCalTBHit>* ATLTileCalTBHitAllocator;
+
+#ifdef ATLTileCalTB_SubEvent
+inline void* ATLTileCalTBHit::operator new( std::size_t size ) { return ::operator new(size); }
+
+inline void ATLTileCalTBHit::operator delete( void* hit ) { ::operator delete(hit); }
+#else
+inline void* ATLTileCalTBHit::operator new( std::size_t ) {
+    if ( ! ATLTileCalTBHitAllocator ) ATLTileCalTBHitAllocator = new G4Allocator<ATLTileCalTBHit>;
+    return static_cast<void*>(ATLTileCalTBHitAllocator->MallocSingle());
+}
+
+inline void ATLTileCalTBHit::operator delete( void* hit ) {
+    ATLTileCalTBHitAllocator->FreeSingle(static_cast<ATLTileCalTBHit*>(hit));
+}
+#endif
+
 inline void ATLTileCalTBHit::AddEdep(G4double dEdep) { fEdep += dEdep; }
 
 inline void ATLTileCalTBHit::AddSdep(std::size_t index, G4double dSdepUp, G4double dSdepDown) {
-    fSdepUp[index] += dSdepUp;
-    fSdepDown[index] += dSdepDown;
+    if ( dSdepUp == 0. && dSdepDown == 0. ) return;
+    #ifdef ATLTileCalTB_SparseHits
+    if ( ! fSdepEntries.empty() && fSdepEntries.back().frame == index ) {
+        fSdepEntries.back().up += static_cast<SdepValue>(dSdepUp);
+        fSdepEntries.back().down += static_cast<SdepValue>(dSdepDown);
+    }
+    else {
+        fSdepEntries.push_back({static_cast<std::uint32_t>(index), static_cast<SdepValue>(dSdepUp),
+                                static_cast<SdepValue>(dSdepDown)});
+    }
+    #else
+    fSdepUp[index] += static_cast<SdepValue>(dSdepUp);
+    fSdepDown[index] += static_cast<SdepValue>(dSdepDown);
+    #endif
+    if ( index < fFirstFrame ) fFirstFrame = index;
+    if ( index > fLastFrame ) fLastFrame = index;
 }
 
 inline void ATLTileCalTBHit::AddSdep(G4double time, G4double dSdepUp, G4double dSdepDown) {
     AddSdep(GetBinFromTime(time), dSdepUp, dSdepDown);
 }
 
+#ifdef ATLTileCalTB_DeferredPoisson
+inline void ATLTileCalTBHit::AddExpectedPe(std::size_t index, G4double lambda, G4double uShapeUp, G4double uShapeDown) {
+    if ( lambda == 0. || (uShapeUp == 0. && uShapeDown == 0.) ) return;
+    if ( ! fExpectedPe.empty() && fExpectedPe.back().frame == index &&
+         fExpectedPe.back().uShapeUp == uShapeUp && fExpectedPe.back().uShapeDown == uShapeDown ) {
+        fExpectedPe.back().lambda += lambda;
+    }
+    else {
+        fExpectedPe.push_back({static_cast<std::uint32_t>(index), uShapeUp, uShapeDown, lambda});
+    }
+}
+#endif
+
 inline G4double ATLTileCalTBHit::GetEdep() const { return fEdep; }
 
-inline const std::array<G4double, ATLTileCalTBConstants::frames>& ATLTileCalTBHit::GetSdepUp() const { return fSdepUp; }
+#ifdef ATLTileCalTB_SparseHits
+inline const std::vector<ATLTileCalTBHit::SdepEntry>& ATLTileCalTBHit::GetSdepEntries() const { return fSdepEntries; }
+#else
+inline const ATLTileCalTBHit::SdepValue* ATLTileCalTBHit::GetSdepUp() const { return fSdepUp; }
+
+inline const ATLTileCalTBHit::SdepValue* ATLTileCalTBHit::GetSdepDown() const { return fSdepDown; }
+#endif
+
+inline G4bool ATLTileCalTBHit::IsActive() const { return fFirstFrame <= fLastFrame; }
+
+inline std::size_t ATLTileCalTBHit::GetFirstFrame() const { return fFirstFrame; }
 
-inline const std::array<G4double, ATLTileCalTBConstants::frames>& ATLTileCalTBHit::GetSdepDown() const { return fSdepDown; }
+inline std::size_t ATLTileCalTBHit::GetLastFrame() const { return fLastFrame; }
 
 #endif //ATLTileCalTBHit_h 1
 
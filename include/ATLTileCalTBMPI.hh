@@ -0,0 +1,87 @@
+//**************************************************
+// \file ATLTileCalTBMPI.hh
+// \brief: definition of ATLTileCalTBMPI
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// MPI-distributed runs: every rank executes the same macro and each run
+// is shared by all the ranks. The event IDs of a run are handed out in
+// chunks of /ATLTileCalTB/mpi/grain events by an atomic counter on rank 0
+// (MPI one-sided fetch-and-add), so faster ranks take more events; the
+// event slots a rank does not get are left without primaries. Events are
+// seeded from their run and event IDs as in sharded runs. Each rank
+// writes ATLTileCalTBout_Run<N>_Rank<i>.root, merged by rank 0 into
+// ATLTileCalTBout_Run<N>.root at the end of the run (with per-thread
+// files the rank outputs are kept and read as a chain). MPI calls are
+// serialized by a mutex, the worker threads take the events.
+
+#ifdef ATLTileCalTB_MPI
+
+#ifndef ATLTileCalTBMPI_h
+#define ATLTileCalTBMPI_h 1
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+#include "G4GenericMessenger.hh"
+#include "G4Threading.hh"
+
+//Includers from MPI
+//
+#include <mpi.h>
+
+class ATLTileCalTBMPI {
+
+    public:
+        static ATLTileCalTBMPI* GetInstance();
+
+        //To be called by main() before and after everything else
+        void Initialize( int* argc, char*** argv );
+        void Finalize();
+
+        G4int GetRank() const { return fRank; }
+        G4int GetSize() const { return fSize; }
+
+        //Rank master thread, at the begin of each run
+        void BeginOfRun( G4int events );
+        //Next event ID of the run, -1 when all the events are taken
+        G4int NextEvent();
+        //Rank master thread, once the rank output is closed: merge
+        //the rank outputs <name>_Rank<i>.root into <name>.root
+        void EndOfRun( const G4String& name );
+
+        //Suffix of the rank output files
+        G4String GetFileSuffix() const;
+        void Print() const;
+
+    private:
+        ATLTileCalTBMPI();
+        ~ATLTileCalTBMPI();
+
+        void MergeOutputs( const G4String& name ) const;
+
+        G4int fRank;
+        G4int fSize;
+        G4int fGrain;
+        G4int fEvents;           //events of the current run
+        G4long fNext;            //next event of the chunk taken by the rank
+        G4long fEnd;             //end of the chunk taken by the rank
+        G4long fSimulated;       //events simulated by the rank in the run
+        long* fCounter;          //next free event ID, on rank 0 only
+        MPI_Win fWindow;
+        G4Mutex fMutex;
+        G4GenericMessenger* fMessenger;
+
+    public:
+        ATLTileCalTBMPI(ATLTileCalTBMPI const&) = delete;
+        void operator=(ATLTileCalTBMPI const&) = delete;
+
+};
+
+#endif //ATLTileCalTBMPI_h
+#endif //ATLTileCalTB_MPI
+
+//**************************************************
@@ -0,0 +1,460 @@
+//**************************************************
+// \file ATLTileCalTBPulseKernel.hh
+// \brief: definition of ATLTileCalTBPulseKernel
+//         class template
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Fused PMT convolution and peak finding.
+// Both PMT signals of a cell are convoluted together in output-stationary
+// form (each output frame accumulates the whole response), and the maximum
+// of each pulse is reduced in the same pass. The instruction set is chosen
+// at runtime among AVX-512, AVX2 (with FMA), SSE4.2 and a scalar reference.
+// Binning (ATLTileCalTBBinning) gives the bins of the signal and the frames
+// of the pulse, NResponse the length of the response. With a coarse tail
+// each output frame accumulates the response of the fine bins frame by
+// frame and only one response sample per coarse bin in reach.
+
+#ifndef ATLTileCalTBPulseKernel_h
+#define ATLTileCalTBPulseKernel_h 1
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+
+//Includers from C++
+//
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+#if defined(__x86_64__) && defined(__GNUC__)
+#define ATLTileCalTB_X86KERNELS 1
+#include <immintrin.h>
+#endif
+
+template <class Binning, std::size_t NResponse>
+class ATLTileCalTBPulseKernel {
+
+    static_assert(NResponse >= 16, "Response shorter than two of the widest vectors");
+    static constexpr std::size_t NFrames = Binning::windowFrames;
+
+    public:
+        using Pulse = std::array<G4double, NFrames>;
+        using Response = std::array<G4double, NResponse>;
+
+        enum class ISA { Scalar, SSE42, AVX2, AVX512 };
+
+        explicit ATLTileCalTBPulseKernel( const Response& response, ISA isa = GetBestISA() );
+
+        //Best instruction set supported by the running CPU
+        static ISA GetBestISA();
+        static const char* GetISAName( ISA isa );
+        ISA GetISA() const { return fISA; }
+
+        //Convolute the up and down signals (Binning::bins values, zero outside
+        //of [firstBin, lastBin]) and return the maximum of each pulse over the
+        //frames from the one of firstBin. The pulses are also stored if pulseUp
+        //and pulseDown are given. Signals stored in single precision are
+        //widened when copied in.
+        template <typename Value>
+        void ConvoluteMax( const Value* sdepUp, const Value* sdepDown,
+                           std::size_t firstBin, std::size_t lastBin,
+                           G4double& maxUp, G4double& maxDown,
+                           Pulse* pulseUp = nullptr, Pulse* pulseDown = nullptr ) const;
+
+    private:
+        //Fine bin n is stored at fOffset + n, surrounded by zeros,
+        //so that vectors can read past the signal range without checks
+        static constexpr std::size_t fOffset = NResponse - 1;
+        static constexpr std::size_t fPaddedSize = fOffset + NFrames + 8;
+
+        //Coarse bins read the response at k - frame for the output frames k
+        //of two of the widest vectors, the response is padded with zeros
+        static constexpr std::size_t fResponsePad = 16;
+        static constexpr std::size_t fCoarseBins = Binning::bins - Binning::fineFrames;
+
+        //Coarse bins contributing to the output frames [k, k + n)
+        std::pair<std::ptrdiff_t, std::ptrdiff_t> CoarseRange( std::size_t k, std::size_t n ) const;
+        //Response at frames k - (frame of coarse bin c) and after
+        const G4double* CoarseResponse( std::size_t k, std::ptrdiff_t c ) const {
+            return fPaddedResponse.data() + fResponsePad + k - Binning::GetFrame(static_cast<std::size_t>(c));
+        }
+
+        //Output frames [begin, end) computed by the vector kernels
+        void Scalar( std::size_t first, std::size_t last, std::size_t begin, std::size_t end,
+                     G4double& maxUp, G4double& maxDown, G4double* pulseUp, G4double* pulseDown ) const;
+        #ifdef ATLTileCalTB_X86KERNELS
+        __attribute__((target("sse4.2")))
+        void SSE42( std::size_t first, std::size_t last, std::size_t& begin, std::size_t end,
+                    G4double& maxUp, G4double& maxDown, G4double* pulseUp, G4double* pulseDown ) const;
+        __attribute__((target("avx2,fma")))
+        void AVX2( std::size_t first, std::size_t last, std::size_t& begin, std::size_t end,
+                   G4double& maxUp, G4double& maxDown, G4double* pulseUp, G4double* pulseDown ) const;
+        __attribute__((target("avx512f")))
+        void AVX512( std::size_t first, std::size_t last, std::size_t& begin, std::size_t end,
+                     G4double& maxUp, G4double& maxDown, G4double* pulseUp, G4double* pulseDown ) const;
+        #endif
+
+        //Response indices contributing to output frame k from fine bins in [first, last]
+        static std::size_t JMin( std::size_t k, std::size_t last ) { return (k > last) ? k - last : 0; }
+        static std::size_t JMax( std::size_t k, std::size_t first ) { return std::min(k - first, NResponse - 1); }
+
+        const Response& fResponse;
+        ISA fISA;
+        mutable std::vector<G4double> fPaddedUp;
+        mutable std::vector<G4double> fPaddedDown;
+
+        //Coarse bins of the signals, bin Binning::fineFrames first, and
+        //the range of the current call (empty if first > last)
+        std::vector<G4double> fPaddedResponse;
+        mutable std::vector<G4double> fCoarseUp;
+        mutable std::vector<G4double> fCoarseDown;
+        mutable std::ptrdiff_t fCoarseFirst;
+        mutable std::ptrdiff_t fCoarseLast;
+
+};
+
+//GetBestISA() method
+//
+template <class Binning, std::size_t NResponse>
+typename ATLTileCalTBPulseKernel<Binning, NResponse>::ISA
+ATLTileCalTBPulseKernel<Binning, NResponse>::GetBestISA() {
+    #ifdef ATLTileCalTB_X86KERNELS
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports("avx512f") ) return ISA::AVX512;
+    if ( __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ) return ISA::AVX2;
+    if ( __builtin_cpu_supports("sse4.2") ) return ISA::SSE42;
+    #endif
+    return ISA::Scalar;
+}
+
+//GetISAName() method
+//
+template <class Binning, std::size_t NResponse>
+const char* ATLTileCalTBPulseKernel<Binning, NResponse>::GetISAName( ISA isa ) {
+    switch ( isa ) {
+        case ISA::SSE42: return "SSE4.2";
+        case ISA::AVX2: return "AVX2";
+        case ISA::AVX512: return "AVX-512";
+        default: return "scalar";
+    }
+}
+
+//Constructor
+//
+template <class Binning, std::size_t NResponse>
+ATLTileCalTBPulseKernel<Binning, NResponse>::ATLTileCalTBPulseKernel( const Response& response, ISA isa )
+    : fResponse(response),
+      fISA(isa),
+      fPaddedUp(fPaddedSize, 0.),
+      fPaddedDown(fPaddedSize, 0.),
+      fCoarseUp(fCoarseBins, 0.),
+      fCoarseDown(fCoarseBins, 0.),
+      fCoarseFirst(0),
+      fCoarseLast(-1) {
+    if constexpr ( ! Binning::uniform ) {
+        fPaddedResponse.assign(NResponse + 2 * fResponsePad, 0.);
+        std::copy(response.begin(), response.end(), fPaddedResponse.begin() + fResponsePad);
+    }
+}
+
+//ConvoluteMax() method
+//
+template <class Binning, std::size_t NResponse>
+template <typename Value>
+void ATLTileCalTBPulseKernel<Binning, NResponse>::ConvoluteMax( const Value* sdepUp, const Value* sdepDown,
+                                                                std::size_t firstBin, std::size_t lastBin,
+                                                                G4double& maxUp, G4double& maxDown,
+                                                                Pulse* pulseUp, Pulse* pulseDown ) const {
+
+    G4double* outUp = pulseUp ? pulseUp->data() : nullptr;
+    G4double* outDown = pulseDown ? pulseDown->data() : nullptr;
+    if ( outUp ) std::fill(outUp, outUp + NFrames, 0.);
+    if ( outDown ) std::fill(outDown, outDown + NFrames, 0.);
+
+    //Empty signals give empty pulses
+    //
+    if ( firstBin > lastBin ) {
+        maxUp = 0.;
+        maxDown = 0.;
+        return;
+    }
+
+    //Fine bins [firstBin, lastFine] are their own frames, empty if
+    //the signal starts after the fine-binning limit
+    //
+    const auto lastFine = std::min(lastBin, Binning::fineFrames - 1);
+    if ( firstBin <= lastFine ) {
+        std::copy(sdepUp + firstBin, sdepUp + lastFine + 1, fPaddedUp.begin() + fOffset + firstBin);
+        std::copy(sdepDown + firstBin, sdepDown + lastFine + 1, fPaddedDown.begin() + fOffset + firstBin);
+    }
+    if constexpr ( ! Binning::uniform ) {
+        const auto firstCoarse = std::max(firstBin, Binning::fineFrames);
+        fCoarseFirst = static_cast<std::ptrdiff_t>(firstCoarse);
+        fCoarseLast = static_cast<std::ptrdiff_t>(lastBin);
+        for ( auto n = firstCoarse; n <= lastBin; ++n ) {
+            fCoarseUp[n - Binning::fineFrames] = sdepUp[n];
+            fCoarseDown[n - Binning::fineFrames] = sdepDown[n];
+        }
+    }
+
+    //Pulses are zero after the response of the last bin
+    //
+    const auto end = std::min(NFrames, Binning::GetFrame(lastBin) + NResponse);
+    maxUp = (end < NFrames) ? 0. : std::numeric_limits<G4double>::lowest();
+    maxDown = maxUp;
+
+    std::size_t begin = Binning::GetFrame(firstBin);
+    #ifdef ATLTileCalTB_X86KERNELS
+    switch ( fISA ) {
+        case ISA::AVX512:
+            AVX512(firstBin, lastFine, begin, end, maxUp, maxDown, outUp, outDown);
+            break;
+        case ISA::AVX2:
+            AVX2(firstBin, lastFine, begin, end, maxUp, maxDown, outUp, outDown);
+            break;
+        case ISA::SSE42:
+            SSE42(firstBin, lastFine, begin, end, maxUp, maxDown, outUp, outDown);
+            break;
+        default:
+            break;
+    }
+    #endif
+    //Remaining frames (all of them for the scalar reference)
+    //
+    Scalar(firstBin, lastFine, begin, end, maxUp, maxDown, outUp, outDown);
+
+    //Leave the padded buffers zeroed for the next call
+    //
+    if ( firstBin <= lastFine ) {
+        std::fill(fPaddedUp.begin() + fOffset + firstBin, fPaddedUp.begin() + fOffset + lastFine + 1, 0.);
+        std::fill(fPaddedDown.begin() + fOffset + firstBin, fPaddedDown.begin() + fOffset + lastFine + 1, 0.);
+    }
+
+}
+
+//CoarseRange() method
+//
+template <class Binning, std::size_t NResponse>
+std::pair<std::ptrdiff_t, std::ptrdiff_t>
+ATLTileCalTBPulseKernel<Binning, NResponse>::CoarseRange( std::size_t k, std::size_t n ) const {
+    const auto frame = static_cast<std::ptrdiff_t>(k);
+    return { std::max(fCoarseFirst, Binning::GetFirstBin(frame - static_cast<std::ptrdiff_t>(NResponse) + 1)),
+             std::min(fCoarseLast, Binning::GetLastBin(frame + static_cast<std::ptrdiff_t>(n) - 1)) };
+}
+
+//Scalar() method
+//
+template <class Binning, std::size_t NResponse>
+void ATLTileCalTBPulseKernel<Binning, NResponse>::Scalar( std::size_t first, std::size_t last,
+                                                          std::size_t begin, std::size_t end,
+                                                          G4double& maxUp, G4double& maxDown,
+                                                          G4double* pulseUp, G4double* pulseDown ) const {
+
+    const G4double* inUp = fPaddedUp.data() + fOffset;
+    const G4double* inDown = fPaddedDown.data() + fOffset;
+    const G4bool fine = Binning::uniform || first <= last;
+    for ( std::size_t k = begin; k < end; ++k ) {
+        G4double outsumUp = 0.;
+        G4double outsumDown = 0.;
+        if ( fine ) {
+            const auto jmax = JMax(k, first);
+            for ( std::size_t j = JMin(k, last); j <= jmax; ++j ) {
+                outsumUp += inUp[k - j] * fResponse[j];
+                outsumDown += inDown[k - j] * fResponse[j];
+            }
+        }
+        if constexpr ( ! Binning::uniform ) {
+            const auto [cmin, cmax] = CoarseRange(k, 1);
+            for ( auto c = cmin; c <= cmax; ++c ) {
+                const G4double response = *CoarseResponse(k, c);
+                outsumUp += fCoarseUp[c - Binning::fineFrames] * response;
+                outsumDown += fCoarseDown[c - Binning::fineFrames] * response;
+            }
+        }
+        maxUp = std::max(maxUp, outsumUp);
+        maxDown = std::max(maxDown, outsumDown);
+        if ( pulseUp ) pulseUp[k] = outsumUp;
+        if ( pulseDown ) pulseDown[k] = outsumDown;
+    }
+
+}
+
+#ifdef ATLTileCalTB_X86KERNELS
+
+//SSE42() method
+//Two output frames per vector, two vectors per signal in flight
+//
+template <class Binning, std::size_t NResponse>
+__attribute__((target("sse4.2")))
+void ATLTileCalTBPulseKernel<Binning, NResponse>::SSE42( std::size_t first, std::size_t last,
+                                                         std::size_t& begin, std::size_t end,
+                                                         G4double& maxUp, G4double& maxDown,
+                                                         G4double* pulseUp, G4double* pulseDown ) const {
+
+    constexpr std::size_t width = 2;
+    const G4double* inUp = fPaddedUp.data() + fOffset;
+    const G4double* inDown = fPaddedDown.data() + fOffset;
+    const G4bool fine = Binning::uniform || first <= last;
+    __m128d vmaxUp = _mm_set1_pd(maxUp);
+    __m128d vmaxDown = _mm_set1_pd(maxDown);
+    std::size_t k = begin;
+    for ( ; k + 2 * width <= end; k += 2 * width ) {
+        __m128d up0 = _mm_setzero_pd(), up1 = _mm_setzero_pd();
+        __m128d down0 = _mm_setzero_pd(), down1 = _mm_setzero_pd();
+        const auto jmax = fine ? JMax(k + 2 * width - 1, first) : 0;
+        for ( std::size_t j = JMin(k, last); fine && j <= jmax; ++j ) {
+            const __m128d response = _mm_set1_pd(fResponse[j]);
+            up0 = _mm_add_pd(up0, _mm_mul_pd(_mm_loadu_pd(inUp + k - j), response));
+            up1 = _mm_add_pd(up1, _mm_mul_pd(_mm_loadu_pd(inUp + k + width - j), response));
+            down0 = _mm_add_pd(down0, _mm_mul_pd(_mm_loadu_pd(inDown + k - j), response));
+            down1 = _mm_add_pd(down1, _mm_mul_pd(_mm_loadu_pd(inDown + k + width - j), response));
+        }
+        if constexpr ( ! Binning::uniform ) {
+            const auto [cmin, cmax] = CoarseRange(k, 2 * width);
+            for ( auto c = cmin; c <= cmax; ++c ) {
+                const G4double* response = CoarseResponse(k, c);
+                const __m128d r0 = _mm_loadu_pd(response), r1 = _mm_loadu_pd(response + width);
+                const __m128d sUp = _mm_set1_pd(fCoarseUp[c - Binning::fineFrames]);
+                const __m128d sDown = _mm_set1_pd(fCoarseDown[c - Binning::fineFrames]);
+                up0 = _mm_add_pd(up0, _mm_mul_pd(r0, sUp));
+                up1 = _mm_add_pd(up1, _mm_mul_pd(r1, sUp));
+                down0 = _mm_add_pd(down0, _mm_mul_pd(r0, sDown));
+                down1 = _mm_add_pd(down1, _mm_mul_pd(r1, sDown));
+            }
+        }
+        vmaxUp = _mm_max_pd(vmaxUp, _mm_max_pd(up0, up1));
+        vmaxDown = _mm_max_pd(vmaxDown, _mm_max_pd(down0, down1));
+        if ( pulseUp ) { _mm_storeu_pd(pulseUp + k, up0); _mm_storeu_pd(pulseUp + k + width, up1); }
+        if ( pulseDown ) { _mm_storeu_pd(pulseDown + k, down0); _mm_storeu_pd(pulseDown + k + width, down1); }
+    }
+    alignas(16) G4double lanes[width];
+    _mm_store_pd(lanes, vmaxUp);
+    maxUp = std::max(lanes[0], lanes[1]);
+    _mm_store_pd(lanes, vmaxDown);
+    maxDown = std::max(lanes[0], lanes[1]);
+    begin = k;
+
+}
+
+//AVX2() method
+//Four output frames per vector, two vectors per signal in flight
+//
+template <class Binning, std::size_t NResponse>
+__attribute__((target("avx2,fma")))
+void ATLTileCalTBPulseKernel<Binning, NResponse>::AVX2( std::size_t first, std::size_t last,
+                                                        std::size_t& begin, std::size_t end,
+                                                        G4double& maxUp, G4double& maxDown,
+                                                        G4double* pulseUp, G4double* pulseDown ) const {
+
+    constexpr std::size_t width = 4;
+    const G4double* inUp = fPaddedUp.data() + fOffset;
+    const G4double* inDown = fPaddedDown.data() + fOffset;
+    const G4bool fine = Binning::uniform || first <= last;
+    __m256d vmaxUp = _mm256_set1_pd(maxUp);
+    __m256d vmaxDown = _mm256_set1_pd(maxDown);
+    std::size_t k = begin;
+    for ( ; k + 2 * width <= end; k += 2 * width ) {
+        __m256d up0 = _mm256_setzero_pd(), up1 = _mm256_setzero_pd();
+        __m256d down0 = _mm256_setzero_pd(), down1 = _mm256_setzero_pd();
+        const auto jmax = fine ? JMax(k + 2 * width - 1, first) : 0;
+        for ( std::size_t j = JMin(k, last); fine && j <= jmax; ++j ) {
+            const __m256d response = _mm256_broadcast_sd(&fResponse[j]);
+            up0 = _mm256_fmadd_pd(_mm256_loadu_pd(inUp + k - j), response, up0);
+            up1 = _mm256_fmadd_pd(_mm256_loadu_pd(inUp + k + width - j), response, up1);
+            down0 = _mm256_fmadd_pd(_mm256_loadu_pd(inDown + k - j), response, down0);
+            down1 = _mm256_fmadd_pd(_mm256_loadu_pd(inDown + k + width - j), response, down1);
+        }
+        if constexpr ( ! Binning::uniform ) {
+            const auto [cmin, cmax] = CoarseRange(k, 2 * width);
+            for ( auto c = cmin; c <= cmax; ++c ) {
+                const G4double* response = CoarseResponse(k, c);
+                const __m256d r0 = _mm256_loadu_pd(response), r1 = _mm256_loadu_pd(response + width);
+                const __m256d sUp = _mm256_broadcast_sd(&fCoarseUp[c - Binning::fineFrames]);
+                const __m256d sDown = _mm256_broadcast_sd(&fCoarseDown[c - Binning::fineFrames]);
+                up0 = _mm256_fmadd_pd(r0, sUp, up0);
+                up1 = _mm256_fmadd_pd(r1, sUp, up1);
+                down0 = _mm256_fmadd_pd(r0, sDown, down0);
+                down1 = _mm256_fmadd_pd(r1, sDown, down1);
+            }
+        }
+        vmaxUp = _mm256_max_pd(vmaxUp, _mm256_max_pd(up0, up1));
+        vmaxDown = _mm256_max_pd(vmaxDown, _mm256_max_pd(down0, down1));
+        if ( pulseUp ) { _mm256_storeu_pd(pulseUp + k, up0); _mm256_storeu_pd(pulseUp + k + width, up1); }
+        if ( pulseDown ) { _mm256_storeu_pd(pulseDown + k, down0); _mm256_storeu_pd(pulseDown + k + width, down1); }
+    }
+    alignas(32) G4double lanes[width];
+    _mm256_store_pd(lanes, vmaxUp);
+    maxUp = *std::max_element(lanes, lanes + width);
+    _mm256_store_pd(lanes, vmaxDown);
+    maxDown = *std::max_element(lanes, lanes + width);
+    begin = k;
+
+}
+
+//AVX512() method
+//Eight output frames per vector, two vectors per signal in flight
+//
+template <class Binning, std::size_t NResponse>
+__attribute__((target("avx512f")))
+void ATLTileCalTBPulseKernel<Binning, NResponse>::AVX512( std::size_t first, std::size_t last,
+                                                          std::size_t& begin, std::size_t end,
+                                                          G4double& maxUp, G4double& maxDown,
+                                                          G4double* pulseUp, G4double* pulseDown ) const {
+
+    constexpr std::size_t width = 8;
+    const G4double* inUp = fPaddedUp.data() + fOffset;
+    const G4double* inDown = fPaddedDown.data() + fOffset;
+    const G4bool fine = Binning::uniform || first <= last;
+    __m512d vmaxUp = _mm512_set1_pd(maxUp);
+    __m512d vmaxDown = _mm512_set1_pd(maxDown);
+    std::size_t k = begin;
+    for ( ; k + 2 * width <= end; k += 2 * width ) {
+        __m512d up0 = _mm512_setzero_pd(), up1 = _mm512_setzero_pd();
+        __m512d down0 = _mm512_setzero_pd(), down1 = _mm512_setzero_pd();
+        const auto jmax = fine ? JMax(k + 2 * width - 1, first) : 0;
+        for ( std::size_t j = JMin(k, last); fine && j <= jmax; ++j ) {
+            const __m512d response = _mm512_set1_pd(fResponse[j]);
+            up0 = _mm512_fmadd_pd(_mm512_loadu_pd(inUp + k - j), response, up0);
+            up1 = _mm512_fmadd_pd(_mm512_loadu_pd(inUp + k + width - j), response, up1);
+            down0 = _mm512_fmadd_pd(_mm512_loadu_pd(inDown + k - j), response, down0);
+            down1 = _mm512_fmadd_pd(_mm512_loadu_pd(inDown + k + width - j), response, down1);
+        }
+        if constexpr ( ! Binning::uniform ) {
+            const auto [cmin, cmax] = CoarseRange(k, 2 * width);
+            for ( auto c = cmin; c <= cmax; ++c ) {
+                const G4double* response = CoarseResponse(k, c);
+                const __m512d r0 = _mm512_loadu_pd(response), r1 = _mm512_loadu_pd(response + width);
+                const __m512d sUp = _mm512_set1_pd(fCoarseUp[c - Binning::fineFrames]);
+                const __m512d sDown = _mm512_set1_pd(fCoarseDown[c - Binning::fineFrames]);
+                up0 = _mm512_fmadd_pd(r0, sUp, up0);
+                up1 = _mm512_fmadd_pd(r1, sUp, up1);
+                down0 = _mm512_fmadd_pd(r0, sDown, down0);
+                down1 = _mm512_fmadd_pd(r1, sDown, down1);
+            }
+        }
+        //Masked forms, the unmasked ones trip -Wuninitialized in GCC headers
+        vmaxUp = _mm512_mask_max_pd(vmaxUp, 0xFF, vmaxUp, _mm512_mask_max_pd(up0, 0xFF, up0, up1));
+        vmaxDown = _mm512_mask_max_pd(vmaxDown, 0xFF, vmaxDown, _mm512_mask_max_pd(down0, 0xFF, down0, down1));
+        if ( pulseUp ) { _mm512_storeu_pd(pulseUp + k, up0); _mm512_storeu_pd(pulseUp + k + width, up1); }
+        if ( pulseDown ) { _mm512_storeu_pd(pulseDown + k, down0); _mm512_storeu_pd(pulseDown + k + width, down1); }
+    }
+    alignas(64) G4double lanes[width];
+    _mm512_store_pd(lanes, vmaxUp);
+    maxUp = *std::max_element(lanes, lanes + width);
+    _mm512_store_pd(lanes, vmaxDown);
+    maxDown = *std::max_element(lanes, lanes + width);
+    begin = k;
+
+}
+
+#endif //ATLTileCalTB_X86KERNELS
+
+#endif //ATLTileCalTBPulseKernel_h
+
+//**************************************************
@@ -14,6 +14,7 @@
 //
 #include "G4UserRunAction.hh"
 #include "G4Timer.hh"
+#include "G4Accumulable.hh"
 
 //Forward declaration from project
 //
@@ -32,12 +33,28 @@ class ATLTileCalTBRunAction : public G4UserRunAction {
         virtual void BeginOfRunAction(const G4Run*);
         virtual void EndOfRunAction(const G4Run*);
 
+        //Count a track killed by the culling
+        void AddCulledTrack( G4double kineticEnergy );
+
     private:
+        //False on the master of a multi-thread run with per-thread files
+        G4bool HasOutputFile() const;
+
+        //Print the finish times of the worker threads, master only
+        void PrintThreadTimes() const;
+
         ATLTileCalTBEventAction* fEventAction;
         G4Timer fTimer;
+        G4Accumulable<G4long> fCulledTracks;
+        G4Accumulable<G4double> fCulledEnergy;
 
 };
 
+inline void ATLTileCalTBRunAction::AddCulledTrack( G4double kineticEnergy ) {
+    fCulledTracks += 1;
+    fCulledEnergy += kineticEnergy;
+}
+
 #endif //ATLTileCalTBRunAction_h 1
 
 //**************************************************
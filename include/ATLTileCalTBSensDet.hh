@@ -12,18 +12,39 @@
 //Includers from Geant4
 //
 #include "G4VSensitiveDetector.hh"
+#ifdef ATLTileCalTB_FastSim
+#include "G4VFastSimSensitiveDetector.hh"
+#endif
 
 //Includers form project files
 //
 #include "ATLTileCalTBHit.hh"
 #include "ATLTileCalTBGeometry.hh"
+#ifndef ATLTileCalTB_SparseHits
+#include "ATLTileCalTBSignalBuffer.hh"
+#endif
+#ifdef ATLTileCalTB_StepBuffer
+#include "ATLTileCalTBStepBuffer.hh"
+#endif
+
+//Includers from C++
+//
+#include <array>
+#include <cstdint>
+#include <vector>
 
 //Forward declaration from Geant4
 //
 class G4Step;
 class G4HCofThisEvent;
+class G4VPhysicalVolume;
+class G4VTouchable;
 
-class ATLTileCalTBSensDet : public G4VSensitiveDetector {
+class ATLTileCalTBSensDet : public G4VSensitiveDetector
+                            #ifdef ATLTileCalTB_FastSim
+                            , public G4VFastSimSensitiveDetector
+                            #endif
+                            {
   
     public:
         ATLTileCalTBSensDet( const G4String& name, const G4String& hitsCollectionName );
@@ -34,12 +55,66 @@ class ATLTileCalTBSensDet : public G4VSensitiveDetector {
         virtual void Initialize( G4HCofThisEvent* hitCollection );
         virtual G4bool ProcessHits( G4Step* aStep, G4TouchableHistory* history );
         virtual void   EndOfEvent( G4HCofThisEvent* hitCollection );
+        #ifdef ATLTileCalTB_FastSim
+        //Deposits of the parameterized and frozen showers
+        virtual G4bool ProcessHits( const G4FastHit* aHit, const G4FastTrack* aTrack, G4TouchableHistory* history );
+        #endif
+
+        //Map every scintillator placement of the geometry tree to its cell,
+        //row and U-shape, to be called once after the geometry is built
+        void MapScintillators( const G4VPhysicalVolume* worldPV );
 
     private:
+        //U-shape profiles of the long barrel (LB) and extended barrel (EB) rows
+        enum class UShape { LB_A, LB_BC, LB_D, EB_A, EB_BC, EB_D };
+
+        //Cell index, row (including the missing rows of C10 and D4) and
+        //U-shape of a scintillator placement
+        struct Placement {
+            std::size_t cellIndex = SIZE_MAX;
+            G4int row = 0;
+            UShape uShape = UShape::LB_A;
+        };
+
+        //Placements of a module, indexed by [period copy number][scintillator copy number]
+        static constexpr std::size_t fNoOfRows = 11;
+        struct ModulePlacements {
+            const G4VPhysicalVolume* modulePV;
+            std::vector<std::array<Placement, fNoOfRows>> periods;
+        };
+        std::vector<ModulePlacements> fModulePlacements;
+
+        void MapScintillators( std::vector<const G4VPhysicalVolume*>& path );
+        const Placement& FindPlacement( const G4VTouchable* touchable ) const;
+
         ATLTileCalTBHitsCollection* fHitsCollection;
+        #ifndef ATLTileCalTB_SparseHits
+        //Signal of all the cells, reused every event
+        ATLTileCalTBSignalBuffer fSignalBuffer;
+        #endif
         G4double BirkLaw( const G4Step* aStep) const;
-        std::size_t FindCellIndexFromG4( const G4Step* aStep ) const;
-        G4double Tile_1D_profileRescaled( G4int row, G4double x, G4double y, G4int PMT, ATLTileCalTBGeometry::Cell cell/*, G4int nSide*/);
+
+        #ifdef ATLTileCalTB_StepBuffer
+        //Steps waiting for the response, flushed when full and at the end of the event
+        static constexpr std::size_t fStepBufferCapacity = 4096;
+        ATLTileCalTBStepBuffer fStepBuffer;
+        void BufferStep( const G4Step* aStep );
+        void ProcessSteps();
+        //Birks' law on the buffered steps, branch-free to be vectorized
+        static void BirkLaw( std::size_t n, const G4double* edep, const G4double* weight, const G4double* length,
+                             const G4double* charge, const G4double* density, G4double* response );
+        #endif
+
+        //U-shape response of the up and down PMTs
+        struct UShapeResponse {
+            G4double up;
+            G4double down;
+        };
+        UShapeResponse Tile_1D_profileRescaled( G4int row, G4double x, G4double y, UShape uShape/*, G4int nSide*/) const;
+
+        //Add the signal of a step (photoelectrons or their expected value
+        //with ATLTileCalTB_DeferredPoisson) to the hit of its cell
+        void AddSignal( std::size_t cellIndex, std::size_t frame, G4double edep, G4double sdep, const UShapeResponse& uShapeResponse );
 
 };
 
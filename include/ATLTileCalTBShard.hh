@@ -0,0 +1,60 @@
+//**************************************************
+// \file ATLTileCalTBShard.hh
+// \brief: definition of ATLTileCalTBShard
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Sharded runs: a production is split across N processes, each started
+// with --shard i/N. Shard i simulates the events of every run with
+// event ID % N == i, the other events are left without primaries and
+// are not written. The random engine is reseeded before the primaries
+// of each event from a hash of the base seed, run ID and event ID, so
+// an event gives the same result whatever the shard and thread counts.
+// The outputs are merged by EventID with analysis/MergeShards.C.
+
+#ifndef ATLTileCalTBShard_h
+#define ATLTileCalTBShard_h 1
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+#include "G4GenericMessenger.hh"
+
+class ATLTileCalTBShard {
+
+    public:
+        static ATLTileCalTBShard* GetInstance();
+
+        //Set the shard from a "i/N" string, false if not valid
+        G4bool SetShard( const G4String& shard );
+
+        G4bool IsActive() const { return fCount > 0; }
+        //True if the event is simulated by this shard
+        G4bool Owns( G4int eventID ) const { return fCount == 0 || eventID % fCount == fIndex; }
+        //Seed the random engine of the calling thread for the event
+        void Reseed( G4int runID, G4int eventID ) const;
+        //Suffix of the output files, empty if not sharded
+        G4String GetFileSuffix() const;
+        void Print() const;
+
+    private:
+        ATLTileCalTBShard();
+        ~ATLTileCalTBShard();
+
+        G4int fIndex;
+        G4int fCount; //0 if not sharded
+        G4int fBaseSeed;
+        G4GenericMessenger* fMessenger;
+
+    public:
+        ATLTileCalTBShard(ATLTileCalTBShard const&) = delete;
+        void operator=(ATLTileCalTBShard const&) = delete;
+
+};
+
+#endif //ATLTileCalTBShard_h
+
+//**************************************************
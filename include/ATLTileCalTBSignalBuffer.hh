@@ -0,0 +1,72 @@
+//**************************************************
+// \file ATLTileCalTBSignalBuffer.hh
+// \brief: definition of ATLTileCalTBSignalBuffer
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Binned signal of all the cells in one contiguous [cell][pmt][bin]
+// buffer, each PMT signal aligned to a cache line. The number of bins is
+// the one of the binning selected at startup (ATLTileCalTBTimeBinning). One buffer is owned by
+// the sensitive detector of each thread and reused for the whole run,
+// the hits of an event are views on its cells. A hit still viewing a cell
+// when it is acquired again (kept event) is detached and copies its signal.
+// A hit zeroes the bins it wrote, [first, last], when it releases its cell.
+
+#ifndef ATLTileCalTBSignalBuffer_h
+#define ATLTileCalTBSignalBuffer_h 1
+
+//Includers from project files
+//
+#include "ATLTileCalTBHit.hh"
+
+//Includers from C++
+//
+#include <vector>
+
+class ATLTileCalTBSignalBuffer {
+
+    public:
+        struct CellSignal {
+            ATLTileCalTBHit::SdepValue* up;
+            ATLTileCalTBHit::SdepValue* down;
+        };
+
+        ATLTileCalTBSignalBuffer( std::size_t nCells, std::size_t nBins );
+        ~ATLTileCalTBSignalBuffer();
+        ATLTileCalTBSignalBuffer( const ATLTileCalTBSignalBuffer& ) = delete;
+        ATLTileCalTBSignalBuffer& operator=( const ATLTileCalTBSignalBuffer& ) = delete;
+
+        //Give the signal of a cell to a hit, detaching the previous view
+        CellSignal Acquire( std::size_t cellIndex, ATLTileCalTBHit* hit );
+        void Release( std::size_t cellIndex ) { fViews[cellIndex] = nullptr; }
+
+        std::size_t GetNumberOfCells() const { return fViews.size(); }
+
+    private:
+        //Cache line of the buffer, each PMT signal starts on a new line
+        static constexpr std::size_t fValuesPerLine = 64 / sizeof(ATLTileCalTBHit::SdepValue);
+        struct alignas(64) Line {
+            ATLTileCalTBHit::SdepValue values[fValuesPerLine];
+        };
+
+        std::size_t fLinesPerPMT;
+        std::vector<Line> fLines;
+
+        //Hit viewing each cell, nullptr if none
+        std::vector<ATLTileCalTBHit*> fViews;
+
+};
+
+inline ATLTileCalTBSignalBuffer::CellSignal ATLTileCalTBSignalBuffer::Acquire( std::size_t cellIndex, ATLTileCalTBHit* hit ) {
+    if ( fViews[cellIndex] ) fViews[cellIndex]->Detach();
+    fViews[cellIndex] = hit;
+    auto up = fLines[2 * cellIndex * fLinesPerPMT].values;
+    return {up, up + fLinesPerPMT * fValuesPerLine};
+}
+
+#endif //ATLTileCalTBSignalBuffer_h
+
+//**************************************************
@@ -0,0 +1,55 @@
+//**************************************************
+// \file ATLTileCalTBStackAction.hh
+// \brief: definition of ATLTileCalTBStackAction
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+#ifndef ATLTileCalTBStackAction_h
+#define ATLTileCalTBStackAction_h 1
+
+//Includers from Geant4
+//
+#include "G4UserStackingAction.hh"
+#ifdef ATLTileCalTB_SubEvent
+#include "G4GenericMessenger.hh"
+#endif
+
+//Forward declaration from project
+//
+class ATLTileCalTBRunAction;
+class ATLTileCalTBCulling;
+
+//Forward declaration from Geant4
+//
+class G4Track;
+
+class ATLTileCalTBStackAction : public G4UserStackingAction {
+
+    public:
+        ATLTileCalTBStackAction( ATLTileCalTBRunAction* runAction );
+        virtual ~ATLTileCalTBStackAction();
+
+        virtual G4ClassificationOfNewTrack ClassifyNewTrack( const G4Track* track );
+        #ifdef ATLTileCalTB_SubEvent
+        virtual void PrepareNewEvent();
+        #endif
+
+    private:
+        ATLTileCalTBRunAction* fRunAction;
+        const ATLTileCalTBCulling* fCulling;
+        #ifdef ATLTileCalTB_SubEvent
+        //Secondaries of the primary hadron interaction are sent to
+        //sub-events if the primary is above fSubEventMinEnergy
+        G4double fSubEventMinEnergy;
+        G4bool fSubEvents; //for the current event
+        G4GenericMessenger* fMessenger;
+        #endif
+
+};
+
+#endif //ATLTileCalTBStackAction_h
+
+//**************************************************
@@ -18,17 +18,26 @@
 //Includers from project files
 //
 #include "ATLTileCalTBEventAction.hh"
+#include "ATLTileCalTBGeometry.hh"
+#include "ATLTileCalTBCulling.hh"
+
+//Forward declaration from project
+//
+class ATLTileCalTBRunAction;
 
 class ATLTileCalTBStepAction: public G4UserSteppingAction {
 
     public:
-        ATLTileCalTBStepAction( ATLTileCalTBEventAction* EvtAction );
+        ATLTileCalTBStepAction( ATLTileCalTBEventAction* EvtAction, ATLTileCalTBRunAction* RunAction );
         virtual ~ATLTileCalTBStepAction();
 
         virtual void UserSteppingAction( const G4Step* aStep );
     
     private:
         ATLTileCalTBEventAction* fEventAction;
+        ATLTileCalTBRunAction* fRunAction;
+        const ATLTileCalTBGeometry::VolumeRoleTable* fVolumeRoles;
+        const ATLTileCalTBCulling* fCulling;
 
 };
 
@@ -0,0 +1,87 @@
+//**************************************************
+// \file ATLTileCalTBStepBuffer.hh
+// \brief: definition of ATLTileCalTBStepBuffer
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Struct-of-arrays record of the scintillator steps of an event. The
+// sensitive detector of each thread pushes the transport quantities of a
+// step and computes the response (time binning, Birks' law, U-shape) for
+// all the buffered steps at once, when the buffer is full or at the end
+// of the event. The response columns are filled by the sensitive detector.
+
+#ifndef ATLTileCalTBStepBuffer_h
+#define ATLTileCalTBStepBuffer_h 1
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+
+//Includers from C++
+//
+#include <cstdint>
+#include <vector>
+
+class ATLTileCalTBStepBuffer {
+
+    public:
+        ATLTileCalTBStepBuffer( std::size_t capacity );
+        ~ATLTileCalTBStepBuffer() = default;
+
+        void Push( std::uint32_t aCell, std::uint8_t aRow, std::uint8_t aUShape, G4double aY, G4double aZ,
+                   G4double aTime, G4double aEdep, G4double aWeight, G4double aLength, G4double aCharge,
+                   G4double aDensity );
+
+        std::size_t GetSize() const { return fSize; }
+        G4bool IsFull() const { return fSize == fCapacity; }
+        void Clear() { fSize = 0; }
+
+        //Step columns, valid in [0, GetSize())
+        std::vector<std::uint32_t> cell;
+        std::vector<std::uint8_t> row;
+        std::vector<std::uint8_t> uShape;
+        std::vector<G4double> y; //local coordinates in the scintillator
+        std::vector<G4double> z;
+        std::vector<G4double> time;
+        std::vector<G4double> edep;
+        std::vector<G4double> weight;
+        std::vector<G4double> length;
+        std::vector<G4double> charge;
+        std::vector<G4double> density;
+
+        //Response columns
+        std::vector<std::size_t> frame; //SIZE_MAX if outside of the time window
+        std::vector<G4double> sdep; //after Birks' law
+        std::vector<G4double> up; //U-shape response of the up PMT
+        std::vector<G4double> down; //U-shape response of the down PMT
+
+    private:
+        std::size_t fCapacity;
+        std::size_t fSize;
+
+};
+
+inline void ATLTileCalTBStepBuffer::Push( std::uint32_t aCell, std::uint8_t aRow, std::uint8_t aUShape,
+                                          G4double aY, G4double aZ, G4double aTime, G4double aEdep,
+                                          G4double aWeight, G4double aLength, G4double aCharge,
+                                          G4double aDensity ) {
+    cell[fSize] = aCell;
+    row[fSize] = aRow;
+    uShape[fSize] = aUShape;
+    y[fSize] = aY;
+    z[fSize] = aZ;
+    time[fSize] = aTime;
+    edep[fSize] = aEdep;
+    weight[fSize] = aWeight;
+    length[fSize] = aLength;
+    charge[fSize] = aCharge;
+    density[fSize] = aDensity;
+    ++fSize;
+}
+
+#endif //ATLTileCalTBStepBuffer_h
+
+//**************************************************
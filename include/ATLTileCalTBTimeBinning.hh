@@ -0,0 +1,183 @@
+//**************************************************
+// \file ATLTileCalTBTimeBinning.hh
+// \brief: definition of ATLTileCalTBTimeBinning
+//         class and ATLTileCalTBBinning template
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Time binning of the signal deposits, configured at startup (PreInit)
+// with the /ATLTileCalTB/digi/ commands and shared by all threads.
+// Deposits are binned with ATLTileCalTBConstants::frame_bin_time up to
+// a fine-binning limit and with a coarser bin width after it, up to the
+// time window. Hit storage and digitization are specialized at compile
+// time for the binnings of ATLTileCalTBBinnings::List, the configuration
+// selects the shortest one covering the time window with the same
+// fine-binning limit and coarse bin width. The default (0.5 ns bins
+// over 350 ns) keeps the uniform fast path.
+
+#ifndef ATLTileCalTBTimeBinning_h
+#define ATLTileCalTBTimeBinning_h 1
+
+//Includers from project files
+//
+#include "ATLTileCalTBConstants.hh"
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+#include "G4GenericMessenger.hh"
+
+//Includers from C++
+//
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+//Binning of NWindowFrames frames of frame_bin_time: one bin per frame
+//for the first NFineFrames frames and one bin per NCoarseFrames frames
+//after them. Pulses are computed on the frames, the signal of a coarse
+//bin is placed at the frame of its centre.
+//
+template <std::size_t NWindowFrames, std::size_t NFineFrames, std::size_t NCoarseFrames>
+struct ATLTileCalTBBinning {
+
+    static_assert(NFineFrames <= NWindowFrames && NCoarseFrames >= 1 &&
+                  (NWindowFrames - NFineFrames) % NCoarseFrames == 0, "Coarse bins must fill the time window");
+
+    static constexpr std::size_t windowFrames = NWindowFrames;
+    static constexpr std::size_t fineFrames = NFineFrames;
+    static constexpr std::size_t coarseFrames = NCoarseFrames;
+    static constexpr std::size_t bins = NFineFrames + (NWindowFrames - NFineFrames) / NCoarseFrames;
+    static constexpr G4bool uniform = ( bins == NWindowFrames );
+
+    //Frame of a bin
+    static constexpr std::size_t GetFrame( std::size_t bin ) {
+        if constexpr ( uniform ) return bin;
+        return ( bin < NFineFrames ) ? bin : NFineFrames + (bin - NFineFrames) * NCoarseFrames + (NCoarseFrames - 1) / 2;
+    }
+
+    //First bin placed at or after a frame (can be bins if none)
+    static constexpr std::ptrdiff_t GetFirstBin( std::ptrdiff_t frame ) {
+        if ( frame <= 0 ) return 0;
+        if ( uniform || frame <= fFine ) return frame;
+        const auto offset = frame - fFine - fCentre;
+        return ( offset <= 0 ) ? fFine : fFine + (offset + fCoarse - 1) / fCoarse;
+    }
+
+    //Last bin placed at or before a frame (-1 if none, can be above bins)
+    static constexpr std::ptrdiff_t GetLastBin( std::ptrdiff_t frame ) {
+        if ( uniform || frame < fFine ) return ( frame < 0 ) ? -1 : frame;
+        const auto offset = frame - fFine - fCentre;
+        return ( offset < 0 ) ? fFine - 1 : fFine + offset / fCoarse;
+    }
+
+    private:
+        static constexpr auto fFine = static_cast<std::ptrdiff_t>(NFineFrames);
+        static constexpr auto fCoarse = static_cast<std::ptrdiff_t>(NCoarseFrames);
+        static constexpr std::ptrdiff_t fCentre = (fCoarse - 1) / 2;
+
+};
+
+namespace ATLTileCalTBBinnings {
+
+    //0.5 ns bins over 350 ns (default) and 200 ns
+    using Window350 = ATLTileCalTBBinning<700, 700, 1>;
+    using Window200 = ATLTileCalTBBinning<400, 400, 1>;
+
+    //0.5 ns bins up to 100 ns and 5 ns bins after, over 350 ns and 200 ns
+    using Window350Tail5 = ATLTileCalTBBinning<700, 200, 10>;
+    using Window200Tail5 = ATLTileCalTBBinning<400, 200, 10>;
+
+    //Binnings with a specialized hit storage and digitization, the first is the default
+    using List = std::tuple<Window350, Window200, Window350Tail5, Window200Tail5>;
+
+}
+
+class ATLTileCalTBTimeBinning {
+
+    public:
+        static ATLTileCalTBTimeBinning* GetInstance();
+
+        //Bin of a deposit at the given time, SIZE_MAX if outside of the time window
+        std::size_t GetBin( G4double time ) const;
+
+        //Bins of the signal of a PMT with the selected binning
+        std::size_t GetNoOfBins() const;
+
+        //Call visitor with the selected binning of ATLTileCalTBBinnings::List
+        //(default-constructed), e.g. to create its digitizer
+        template <typename Visitor>
+        decltype(auto) Visit( Visitor&& visitor ) const;
+
+        G4double GetTimeWindow() const { return fTimeWindow; }
+        G4double GetFineBinningLimit() const { return fFineBinningLimit; }
+        G4double GetCoarseBinTime() const { return fCoarseBinTime; }
+        void Print() const;
+
+    private:
+        ATLTileCalTBTimeBinning();
+        ~ATLTileCalTBTimeBinning();
+
+        //Setters used by the messenger
+        void SetTimeWindow( G4double time );
+        void SetFineBinningLimit( G4double time );
+        void SetCoarseBinTime( G4double time );
+
+        //Select the binning of the configuration, fBinning is SIZE_MAX if none
+        void Update();
+        //A configuration without binning is a fatal exception when used
+        void CheckBinning() const;
+
+        template <typename Visitor, std::size_t I = 0>
+        static decltype(auto) VisitBinning( std::size_t index, Visitor&& visitor );
+
+        G4double fTimeWindow;
+        G4double fFineBinningLimit;
+        G4double fCoarseBinTime;
+
+        //Index of the selected binning in ATLTileCalTBBinnings::List
+        //and its frames, used by GetBin()
+        std::size_t fBinning;
+        std::size_t fWindowFrames;
+        std::size_t fFineFrames;
+        std::size_t fCoarseFrames;
+        std::size_t fBins;
+
+        G4GenericMessenger* fMessenger;
+
+};
+
+inline std::size_t ATLTileCalTBTimeBinning::GetBin( G4double time ) const {
+    if ( time > fTimeWindow ) return SIZE_MAX;
+    const auto frame = static_cast<std::size_t>(std::ceil(time / ATLTileCalTBConstants::frame_bin_time));
+    if ( frame >= fWindowFrames ) return SIZE_MAX;
+    return ( frame < fFineFrames ) ? frame : fFineFrames + (frame - fFineFrames) / fCoarseFrames;
+}
+
+inline std::size_t ATLTileCalTBTimeBinning::GetNoOfBins() const {
+    CheckBinning();
+    return fBins;
+}
+
+template <typename Visitor>
+decltype(auto) ATLTileCalTBTimeBinning::Visit( Visitor&& visitor ) const {
+    CheckBinning();
+    return VisitBinning(fBinning, std::forward<Visitor>(visitor));
+}
+
+template <typename Visitor, std::size_t I>
+decltype(auto) ATLTileCalTBTimeBinning::VisitBinning( std::size_t index, Visitor&& visitor ) {
+    using List = ATLTileCalTBBinnings::List;
+    if constexpr ( I + 1 < std::tuple_size_v<List> ) {
+        if ( index != I ) return VisitBinning<Visitor, I + 1>(index, std::forward<Visitor>(visitor));
+    }
+    return visitor(std::tuple_element_t<I, List>{});
+}
+
+#endif //ATLTileCalTBTimeBinning_h
+
+//**************************************************
@@ -0,0 +1,92 @@
+//**************************************************
+// \file ATLTileCalTBVDigitizer.hh
+// \brief: definition of ATLTileCalTBVDigitizer
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+// Interface of the PMT digitization of the hits, implemented by
+// ATLTileCalTBDigitizer for each binning of ATLTileCalTBBinnings::List.
+// Create() returns the digitizer of the binning selected at startup,
+// one instance per thread (owned by the event action). The optimal
+// filtering weights do not depend on the binning and are computed here.
+
+#ifndef ATLTileCalTBVDigitizer_h
+#define ATLTileCalTBVDigitizer_h 1
+
+//Includers from project files
+//
+#include "ATLTileCalTBConstants.hh"
+#include "ATLTileCalTBHit.hh"
+
+//Includers from Geant4
+//
+#include "G4Types.hh"
+
+//Includers from C++
+//
+#include <array>
+#include <memory>
+#include <vector>
+
+class ATLTileCalTBVDigitizer {
+
+    public:
+        using Samples = std::array<G4double, ATLTileCalTBConstants::of_samples>;
+
+        //Digitizer of the binning selected by ATLTileCalTBTimeBinning
+        static std::unique_ptr<ATLTileCalTBVDigitizer> Create();
+
+        ATLTileCalTBVDigitizer();
+        virtual ~ATLTileCalTBVDigitizer();
+
+        //Maximum of the up and down pulses of an active hit,
+        //over the frames from the one of its first bin
+        virtual void DigitizeMax( const ATLTileCalTBHit& hit, G4double& maxUp, G4double& maxDown ) const = 0;
+
+        //Same as DigitizeMax() and the pulses over the frames of the time window
+        virtual void DigitizePulses( const ATLTileCalTBHit& hit, std::vector<G4double>& pulseUp,
+                                     std::vector<G4double>& pulseDown, G4double& maxUp, G4double& maxDown ) const = 0;
+
+        //Optimal filtering: the pulses are evaluated only at the of_samples
+        //sampling times, amplitude and phase are weighted sums of the samples
+        virtual void Sample( const ATLTileCalTBHit& hit, Samples& samplesUp, Samples& samplesDown ) const = 0;
+        G4double GetOFAmplitude( const Samples& samples ) const;
+        G4double GetOFPhase( const Samples& samples, G4double amplitude ) const;
+
+        //Batched digitization of the active hits of one or more events,
+        //AddToBatch() returns the channel of the up PMT (down is next)
+        //to read back with GetBatchMax() after ConvoluteBatch()
+        #ifndef ATLTileCalTB_SparseHits
+        virtual std::size_t AddToBatch( const ATLTileCalTBHit& hit ) = 0;
+        #endif
+        virtual void ConvoluteBatch() = 0;
+        virtual G4double GetBatchMax( std::size_t channel ) const = 0;
+        virtual void ClearBatch() = 0;
+
+        //Microbenchmark and correctness check of the convolution kernels
+        //against the direct one, a failed check is a fatal exception
+        virtual void Benchmark( std::size_t nPulses = 1000 ) const = 0;
+
+    protected:
+        //Frame of the central sample and spacing of the samples
+        static constexpr std::size_t fOFPeakFrame = static_cast<std::size_t>(
+            ATLTileCalTBConstants::of_central_sample_time / ATLTileCalTBConstants::frame_bin_time);
+        static constexpr std::size_t fOFStep = static_cast<std::size_t>(
+            ATLTileCalTBConstants::of_sampling_time / ATLTileCalTBConstants::frame_bin_time);
+        static constexpr std::size_t fOFLastFrame =
+            fOFPeakFrame + (ATLTileCalTBConstants::of_samples - 1 - ATLTileCalTBConstants::of_samples / 2) * fOFStep;
+
+        //Frames of the samples and optimal filtering weights
+        //for the amplitude (fOFWeightsA) and amplitude x phase (fOFWeightsB)
+        std::array<std::size_t, ATLTileCalTBConstants::of_samples> fOFFrames;
+        Samples fOFWeightsA;
+        Samples fOFWeightsB;
+
+};
+
+#endif //ATLTileCalTBVDigitizer_h
+
+//**************************************************
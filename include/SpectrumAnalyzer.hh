@@ -48,7 +48,7 @@ class SpectrumAnalyzer
       neutronScore = 0.;
       protonScore = 0., pionScore = 0., gammaScore = 0., electronScore = 0., othersScore = 0.;
     }
-    void FillEventFields() const;
+    void FillEventFields(G4int eventID) const;
     // Step-wise methods
     void Analyze(const G4Step* step);
 
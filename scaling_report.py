@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Script to compare the run managers and thread counts on a macro"""
+
+from __future__ import annotations
+
+import argparse
+import re
+import subprocess
+import sys
+import time
+
+WALL_TIME_PATTERN = re.compile(r'^\s*Wall time per event\(s\): (\S+)')
+TAIL_LATENCY_PATTERN = re.compile(r'^\s*Tail latency\(s\): (\S+)')
+
+
+def parse_args(args: list[str]) -> argparse.Namespace:
+    """
+    Parses the command-line arguments.
+
+    Args:
+        args: List of strings to parse as command-line arguments.
+    Returns:
+        A namespace with the parsed arguments.
+    """
+    parser = argparse.ArgumentParser(formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+    parser.add_argument('-m', type=str, default='TBrun_all.mac', help='macro to run')
+    parser.add_argument('-r', type=str, nargs='+', default=['mt', 'tasking'],
+                        help='run manager types (serial, mt, tasking, tbb)')
+    parser.add_argument('-t', type=int, nargs='+', default=[1, 2, 4, 8], help='numbers of threads')
+    parser.add_argument('-g', type=int, default=0, help='event modulo, 0 for the Geant4 default')
+    parser.add_argument('-x', type=str, default='./ATLTileCalTB', help='ATLTileCalTB executable')
+
+    return parser.parse_args(args=args)
+
+
+def run_simulation(executable: str, macro: str, run_manager: str, threads: int, event_modulo: int) -> tuple:
+    """
+    Runs the simulation and parses the end of run printouts of the master.
+
+    Args:
+        executable: Path to the ATLTileCalTB executable.
+        macro: Macro file to run.
+        run_manager: Run manager type.
+        threads: Number of threads.
+        event_modulo: Event modulo, not passed if 0.
+    Returns:
+        Total wall time (s), mean wall time per event (s) over the runs
+        and total tail latency (s) over the runs.
+    """
+    command = [executable, '-m', macro, '-r', run_manager, '-t', str(threads)]
+    if event_modulo > 0:
+        command += ['-g', str(event_modulo)]
+
+    start = time.perf_counter()
+    output = subprocess.run(command, capture_output=True, text=True, check=True).stdout
+    wall_time = time.perf_counter() - start
+
+    times_per_event = []
+    tail_latency = 0.
+    for line in output.splitlines():
+        if match := WALL_TIME_PATTERN.match(line):
+            times_per_event.append(float(match.group(1)))
+        elif match := TAIL_LATENCY_PATTERN.match(line):
+            tail_latency += float(match.group(1))
+
+    time_per_event = sum(times_per_event) / len(times_per_event) if times_per_event else float('nan')
+    return wall_time, time_per_event, tail_latency
+
+
+def main(args: list[str] = None) -> None:
+    """
+    Runs the command-line interface.
+
+    Args:
+        args: List of strings to parse as command-line arguments. Defaults to sys.argv if set to None.
+    """
+    if args is None:
+        args = sys.argv[1:]
+
+    cli_options = parse_args(args)
+
+    print(f'{"run manager":>12} {"threads":>8} {"wall time(s)":>13} {"time/event(s)":>14} '
+          f'{"tail latency(s)":>16} {"speedup":>8}')
+    for run_manager in cli_options.r:
+        reference = None
+        for threads in cli_options.t:
+            wall_time, time_per_event, tail_latency = run_simulation(cli_options.x, cli_options.m, run_manager,
+                                                                     threads, cli_options.g)
+            if reference is None:
+                reference = wall_time
+            print(f'{run_manager:>12} {threads:>8} {wall_time:>13.2f} {time_per_event:>14.4f} '
+                  f'{tail_latency:>16.2f} {reference / wall_time:>8.2f}')
+
+
+if __name__ == '__main__':
+    main()
@@ -14,11 +14,17 @@
 #include "ATLTileCalTBRunAction.hh"
 #include "ATLTileCalTBEventAction.hh"
 #include "ATLTileCalTBStepAction.hh"
+#include "ATLTileCalTBStackAction.hh"
+#include "ATLTileCalTBTimeBinning.hh"
+#include "ATLTileCalTBCulling.hh"
 
 //Constructor and de-constructor
 //
 ATLTileCalTBActInitialization::ATLTileCalTBActInitialization()
     : G4VUserActionInitialization() {
+    //Create the time binning and culling now for their PreInit commands
+    ATLTileCalTBTimeBinning::GetInstance();
+    ATLTileCalTBCulling::GetInstance();
 }
 
 ATLTileCalTBActInitialization::~ATLTileCalTBActInitialization() {}
@@ -26,19 +32,26 @@ ATLTileCalTBActInitialization::~ATLTileCalTBActInitialization() {}
 //Define Build() and BuildForMaster() methods
 //
 void ATLTileCalTBActInitialization::BuildForMaster() const {
-    auto EventAction = new ATLTileCalTBEventAction(nullptr);
+    auto EventAction = new ATLTileCalTBEventAction();
     SetUserAction( new ATLTileCalTBRunAction( EventAction ) );
+    #ifdef ATLTileCalTB_SubEvent
+    //The sub-events are merged and their events can end on the master
+    SetUserAction( EventAction );
+    #endif
 
 }
 
 void ATLTileCalTBActInitialization::Build() const {
     auto PrimaryGenAction = new ATLTileCalTBPrimaryGenAction();
-    auto EventAction = new ATLTileCalTBEventAction(PrimaryGenAction);
+    auto EventAction = new ATLTileCalTBEventAction();
+
+    auto RunAction = new ATLTileCalTBRunAction( EventAction );
 
     SetUserAction( PrimaryGenAction );
-    SetUserAction( new ATLTileCalTBRunAction( EventAction ) );
+    SetUserAction( RunAction );
     SetUserAction( EventAction );
-    SetUserAction( new ATLTileCalTBStepAction( EventAction ) );
+    SetUserAction( new ATLTileCalTBStepAction( EventAction, RunAction ) );
+    SetUserAction( new ATLTileCalTBStackAction( RunAction ) );
 
 }
 
@@ -0,0 +1,105 @@
+//**************************************************
+// \file ATLTileCalTBCulling.cc
+// \brief: implementation of ATLTileCalTBCulling
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+//Includers from project files
+//
+#include "ATLTileCalTBCulling.hh"
+
+//Includers from Geant4
+//
+#include "G4ios.hh"
+#include "G4ParticleTable.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+//Includers from C++
+//
+#include <cfloat>
+#include <sstream>
+
+//GetInstance() method
+//One instance per process, configured by the master thread
+//
+ATLTileCalTBCulling* ATLTileCalTBCulling::GetInstance() {
+    static ATLTileCalTBCulling instance;
+    return &instance;
+}
+
+//Constructor and de-constructor
+//
+ATLTileCalTBCulling::ATLTileCalTBCulling()
+    : fEnabled(false),
+      fEnergyThreshold(DBL_MAX),
+      fParticleNames("all"),
+      fTimeBinning(ATLTileCalTBTimeBinning::GetInstance()) {
+
+    //Commands are only allowed between runs and not broadcasted,
+    //as the culling configuration is shared by all threads
+    //
+    fMessenger = new G4GenericMessenger(this, "/ATLTileCalTB/culling/", "Culling of the tracks after the signal time window");
+    fMessenger->DeclareProperty("enable", fEnabled,
+        "Kill the tracks that are past the signal time window")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclarePropertyWithUnit("energyThreshold", "MeV", fEnergyThreshold,
+        "Only tracks with kinetic energy below this threshold are killed")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclareMethod("particles", &ATLTileCalTBCulling::SetParticles,
+        "Space separated names of the particles to be killed, or all")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+
+}
+
+ATLTileCalTBCulling::~ATLTileCalTBCulling() {
+    delete fMessenger;
+}
+
+//SetParticles() method
+//
+void ATLTileCalTBCulling::SetParticles( const G4String& names ) {
+    std::vector<const G4ParticleDefinition*> particles;
+    std::istringstream stream(names);
+    std::string name;
+    while ( stream >> name ) {
+        if ( name == "all" ) {
+            particles.clear();
+            break;
+        }
+        auto particle = G4ParticleTable::GetParticleTable()->FindParticle(name);
+        if ( !particle ) {
+            G4ExceptionDescription msg;
+            msg << "Particle " << name << " not found for culling." << G4endl;
+            G4Exception("ATLTileCalTBCulling::SetParticles()",
+            "MyCode0010", FatalErrorInArgument, msg);
+            return;
+        }
+        particles.push_back(particle);
+    }
+    fParticles = particles;
+    fParticleNames = fParticles.empty() ? G4String("all") : G4String(names);
+}
+
+//Print() method
+//
+void ATLTileCalTBCulling::Print() const {
+    if ( !fEnabled ) {
+        G4cout << "Track culling disabled" << G4endl;
+        return;
+    }
+    G4cout << "Track culling after " << G4BestUnit(fTimeBinning->GetTimeWindow(), "Time")
+           << " for particles: " << fParticleNames;
+    if ( fEnergyThreshold < DBL_MAX ) {
+        G4cout << " below " << G4BestUnit(fEnergyThreshold, "Energy");
+    }
+    G4cout << G4endl;
+}
+
+//**************************************************
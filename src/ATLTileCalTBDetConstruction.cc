@@ -11,6 +11,13 @@
 //
 #include "ATLTileCalTBDetConstruction.hh"
 #include "ATLTileCalTBSensDet.hh"
+#include "ATLTileCalTBGeometry.hh"
+#ifdef ATLTileCalTB_FastSim
+#include "ATLTileCalTBEMShowerModel.hh"
+#include "ATLTileCalTBEMShowerParameters.hh"
+#include "ATLTileCalTBFrozenShowerModel.hh"
+#include "ATLTileCalTBFrozenShowerLibrary.hh"
+#endif
 
 //Includers from Geant4
 //
@@ -19,13 +26,28 @@
 #include "G4LogicalVolumeStore.hh"
 #include "G4VisAttributes.hh"
 #include "G4SDManager.hh"
+#include "G4Region.hh"
+#ifdef ATLTileCalTB_FastSim
+#include "G4RegionStore.hh"
+#include "G4FastSimulationManager.hh"
+#endif
+
+//Includers from C++
+//
+#include <array>
+#include <utility>
 
 //Constructors and de-constructor
 //
 ATLTileCalTBDetConstruction::ATLTileCalTBDetConstruction(const G4GDMLParser& parser) 
     : G4VUserDetectorConstruction(),
-    fParser(parser)
-{}
+    fParser(parser) {
+    #ifdef ATLTileCalTB_FastSim
+    //Create the shower parameters and library now for their PreInit commands
+    ATLTileCalTBEMShowerParameters::GetInstance();
+    ATLTileCalTBFrozenShowerLibrary::GetInstance();
+    #endif
+}
 
 ATLTileCalTBDetConstruction::~ATLTileCalTBDetConstruction()
 {}
@@ -38,6 +60,17 @@ G4VPhysicalVolume* ATLTileCalTBDetConstruction::Construct() {
     
     DefineVisAttributes();
 
+    //Resolve the roles of the logical volumes once, shared by all threads
+    //
+    ATLTileCalTBGeometry::VolumeRoleTable::GetInstance()->Build();
+
+    DefineRegions();
+
+    #ifdef ATLTileCalTB_FastSim
+    //Effective medium of the EM shower parameterization
+    ATLTileCalTBEMShowerParameters::GetInstance()->Update();
+    #endif
+
     return worldPV;
 
 }
@@ -51,15 +84,46 @@ void ATLTileCalTBDetConstruction::ConstructSDandField() {
     auto caloSD = new ATLTileCalTBSensDet( "caloSD", "caloHitsCollection" );
     G4SDManager::GetSDMpointer()->AddNewDetector( caloSD );
 
+    //Map the scintillator placements to cells once, instead of parsing
+    //the volume names at each step
+    //
+    caloSD->MapScintillators( fParser.GetWorldVolume() );
+
     //Assign to logical volumes
     //
+    using ATLTileCalTBGeometry::VolumeRole;
+    auto volumeRoles = ATLTileCalTBGeometry::VolumeRoleTable::GetInstance();
     auto LVStore = G4LogicalVolumeStore::GetInstance();
     for(auto volume : *LVStore) {
 
-        if( volume->GetName()=="Tile::Scintillator" ) volume->SetSensitiveDetector( caloSD );
+        if( volumeRoles->HasAnyRole( volume, VolumeRole::Scintillator ) ) volume->SetSensitiveDetector( caloSD );
     
     }
 
+    #ifdef ATLTileCalTB_FastSim
+    //Parameterized EM showers in the module envelopes and absorbers,
+    //and frozen showers of the low-energy particles in the periods,
+    //which belong to the absorber region. The parameterized model is
+    //tried first and only triggers above its energy threshold. The
+    //scintillators are left to the full simulation as a step starting
+    //there would also deposit the whole shower in their SD
+    //
+    auto showerModel = new ATLTileCalTBEMShowerModel( "TileEMShowerModel" );
+    for( const auto& name : {"TileModules", "TileAbsorber"} ) {
+        auto region = G4RegionStore::GetInstance()->GetRegion( name, false );
+        if( !region ) continue;
+        auto fastSimManager = region->GetFastSimulationManager();
+        if( !fastSimManager ) fastSimManager = new G4FastSimulationManager( region );
+        fastSimManager->AddFastSimulationModel( showerModel );
+    }
+
+    auto absorberRegion = G4RegionStore::GetInstance()->GetRegion( "TileAbsorber", false );
+    if( absorberRegion && absorberRegion->GetFastSimulationManager() ) {
+        absorberRegion->GetFastSimulationManager()->AddFastSimulationModel(
+            new ATLTileCalTBFrozenShowerModel( "TileFrozenShowerModel" ) );
+    }
+    #endif
+
     //No fields involved
 
 }
@@ -103,4 +167,43 @@ void ATLTileCalTBDetConstruction::DefineVisAttributes() {
     }
 }
 
+//DefineRegions() method
+//Regions without specific cuts use the default ones, the cuts of each
+//region are set with /run/setCutForRegion (see cuts_benchmark.mac)
+//
+void ATLTileCalTBDetConstruction::DefineRegions() {
+
+    using ATLTileCalTBGeometry::VolumeRole;
+    const std::array<std::pair<VolumeRole, G4String>, 5> regions = {{
+        {VolumeRole::Absorber, "TileAbsorber"},
+        {VolumeRole::Scintillator, "TileScintillator"},
+        {VolumeRole::GirderFinger, "TileGirderFinger"},
+        {VolumeRole::Beamline, "Beamline"},
+        {VolumeRole::Module, "TileModules"},
+    }};
+
+    auto volumeRoles = ATLTileCalTBGeometry::VolumeRoleTable::GetInstance();
+    auto LVStore = G4LogicalVolumeStore::GetInstance();
+    for(const auto& [role, name] : regions) {
+
+        G4Region* region = nullptr;
+        for(auto volume : *LVStore) {
+            if( !volumeRoles->HasAnyRole( volume, role ) ) continue;
+            if( !region ) region = new G4Region( name );
+            region->AddRootLogicalVolume( volume );
+        }
+
+        //e.g. the Beamline region with the geometry without beamline
+        if( !region ) {
+            G4ExceptionDescription msg;
+            msg << "No volume found for region " << name << ", the region is not created and "
+                << "/run/setCutForRegion " << name << " has no effect." << G4endl;
+            G4Exception("ATLTileCalTBDetConstruction::DefineRegions()",
+            "MyCode0017", JustWarning, msg);
+        }
+
+    }
+
+}
+
 //**************************************************
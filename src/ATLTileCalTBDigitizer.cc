@@ -0,0 +1,870 @@
+//**************************************************
+// \file ATLTileCalTBDigitizer.cc
+// \brief: implementation of ATLTileCalTBDigitizer
+//         class template
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+//Includers from project files
+//
+#include "ATLTileCalTBDigitizer.hh"
+
+//Includers from Geant4
+//
+#include "G4ios.hh"
+#include "G4PhysicalConstants.hh"
+
+//Includers from C++
+//
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <random>
+
+//Constructor and de-constructor
+//
+template <class Binning>
+ATLTileCalTBDigitizer<Binning>::ATLTileCalTBDigitizer()
+    : ATLTileCalTBVDigitizer(),
+      fKernel(ATLTileCalTBConstants::pmt_response),
+      fResponseSpectrum(fFFTSize),
+      fTwiddles(fFFTSize / 2),
+      fBitReverse(fFFTSize),
+      fWorkspace(fFFTSize),
+      fBatchPanel(Binning::bins * fBatchChannels) {
+
+    //Twiddle factors and bit-reversal permutation
+    //
+    for ( std::size_t k = 0; k < fTwiddles.size(); ++k ) {
+        fTwiddles[k] = std::polar(1., -CLHEP::twopi * static_cast<G4double>(k) / static_cast<G4double>(fFFTSize));
+    }
+    std::size_t nBits = 0;
+    while ( (std::size_t(1) << nBits) < fFFTSize ) ++nBits;
+    for ( std::size_t i = 0; i < fFFTSize; ++i ) {
+        std::size_t reversed = 0;
+        for ( std::size_t b = 0; b < nBits; ++b ) {
+            if ( i & (std::size_t(1) << b) ) reversed |= std::size_t(1) << (nBits - 1 - b);
+        }
+        fBitReverse[i] = reversed;
+    }
+
+    //Spectrum of the PMT response, normalized for the inverse transform
+    //
+    std::fill(fResponseSpectrum.begin(), fResponseSpectrum.end(), 0.);
+    std::copy(ATLTileCalTBConstants::pmt_response.begin(), ATLTileCalTBConstants::pmt_response.end(),
+              fResponseSpectrum.begin());
+    FFT(fResponseSpectrum, false);
+    for ( auto& value : fResponseSpectrum ) { value /= static_cast<G4double>(fFFTSize); }
+
+    //Response with zeros on both sides for the batched product
+    //
+    fPaddedResponse.fill(0.);
+    std::copy(ATLTileCalTBConstants::pmt_response.begin(), ATLTileCalTBConstants::pmt_response.end(),
+              fPaddedResponse.begin() + fBatchRows - 1);
+
+}
+
+template <class Binning>
+ATLTileCalTBDigitizer<Binning>::~ATLTileCalTBDigitizer() {}
+
+//DigitizeMax() method
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::DigitizeMax( const ATLTileCalTBHit& hit, G4double& maxUp, G4double& maxDown ) const {
+
+    #ifdef ATLTileCalTB_SparseHits
+    //Pulses are zero before the frame of the first bin
+    Pulse pulseUp, pulseDown;
+    ConvolutePMTSparse(hit.GetSdepEntries(), pulseUp, pulseDown);
+    const auto first = Binning::GetFrame(hit.GetFirstFrame());
+    maxUp = *(std::max_element(pulseUp.begin() + first, pulseUp.end()));
+    maxDown = *(std::max_element(pulseDown.begin() + first, pulseDown.end()));
+    #else
+    //PMT response and maximum in a single pass
+    ConvolutePMTMax(hit.GetSdepUp(), hit.GetSdepDown(), hit.GetFirstFrame(), hit.GetLastFrame(), maxUp, maxDown);
+    #endif
+
+}
+
+//DigitizePulses() method
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::DigitizePulses( const ATLTileCalTBHit& hit, std::vector<G4double>& pulseUp,
+                                                     std::vector<G4double>& pulseDown,
+                                                     G4double& maxUp, G4double& maxDown ) const {
+
+    Pulse up, down;
+    #ifdef ATLTileCalTB_SparseHits
+    ConvolutePMTSparse(hit.GetSdepEntries(), up, down);
+    #else
+    ConvolutePMT(hit.GetSdepUp(), hit.GetSdepDown(), hit.GetFirstFrame(), hit.GetLastFrame(), up, down);
+    #endif
+    pulseUp.assign(up.begin(), up.end());
+    pulseDown.assign(down.begin(), down.end());
+    const auto first = Binning::GetFrame(hit.GetFirstFrame());
+    maxUp = *(std::max_element(up.begin() + first, up.end()));
+    maxDown = *(std::max_element(down.begin() + first, down.end()));
+
+}
+
+//Sample() method
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::Sample( const ATLTileCalTBHit& hit, Samples& samplesUp, Samples& samplesDown ) const {
+
+    #ifdef ATLTileCalTB_SparseHits
+    SamplePMTSparse(hit.GetSdepEntries(), samplesUp, samplesDown);
+    #else
+    SamplePMT(hit.GetSdepUp(), hit.GetSdepDown(), hit.GetFirstFrame(), hit.GetLastFrame(), samplesUp, samplesDown);
+    #endif
+
+}
+
+#ifndef ATLTileCalTB_SparseHits
+//AddToBatch() method for hits
+//
+template <class Binning>
+std::size_t ATLTileCalTBDigitizer<Binning>::AddToBatch( const ATLTileCalTBHit& hit ) {
+
+    const auto channel = AddToBatch(hit.GetSdepUp(), hit.GetFirstFrame(), hit.GetLastFrame());
+    AddToBatch(hit.GetSdepDown(), hit.GetFirstFrame(), hit.GetLastFrame());
+    return channel;
+
+}
+#endif
+
+//FFT() method
+//In-place iterative radix-2 transform
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::FFT( std::vector<std::complex<G4double>>& data, G4bool inverse ) const {
+
+    for ( std::size_t i = 0; i < fFFTSize; ++i ) {
+        if ( i < fBitReverse[i] ) std::swap(data[i], data[fBitReverse[i]]);
+    }
+
+    for ( std::size_t length = 2; length <= fFFTSize; length *= 2 ) {
+        const std::size_t half = length / 2;
+        const std::size_t stride = fFFTSize / length;
+        for ( std::size_t start = 0; start < fFFTSize; start += length ) {
+            for ( std::size_t k = 0; k < half; ++k ) {
+                auto twiddle = inverse ? std::conj(fTwiddles[k * stride]) : fTwiddles[k * stride];
+                auto odd = data[start + k + half] * twiddle;
+                data[start + k + half] = data[start + k] - odd;
+                data[start + k] += odd;
+            }
+        }
+    }
+
+}
+
+//UseKernel() method
+//The vectorized direct convolution is faster than the FFT at any span
+//
+template <class Binning>
+G4bool ATLTileCalTBDigitizer<Binning>::UseKernel( std::size_t firstBin, std::size_t lastBin ) const {
+    return fKernel.GetISA() != Kernel::ISA::Scalar || lastBin - firstBin < fDirectMaxSpan;
+}
+
+//ConvolutePMT() method
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::ConvolutePMT( const Value* sdepUp, const Value* sdepDown,
+                                                   std::size_t firstBin, std::size_t lastBin,
+                                                   Pulse& pulseUp, Pulse& pulseDown ) const {
+
+    //Empty signals stay exactly zero
+    //
+    if ( firstBin > lastBin ) {
+        pulseUp.fill(0.);
+        pulseDown.fill(0.);
+        return;
+    }
+    if ( UseKernel(firstBin, lastBin) ) {
+        G4double maxUp, maxDown;
+        fKernel.ConvoluteMax(sdepUp, sdepDown, firstBin, lastBin, maxUp, maxDown, &pulseUp, &pulseDown);
+        return;
+    }
+    ConvolutePMTFFT(sdepUp, sdepDown, firstBin, lastBin, pulseUp, pulseDown);
+
+}
+
+//ConvolutePMTMax() method
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::ConvolutePMTMax( const Value* sdepUp, const Value* sdepDown,
+                                                      std::size_t firstBin, std::size_t lastBin,
+                                                      G4double& maxUp, G4double& maxDown ) const {
+
+    if ( firstBin > lastBin || UseKernel(firstBin, lastBin) ) {
+        fKernel.ConvoluteMax(sdepUp, sdepDown, firstBin, lastBin, maxUp, maxDown);
+        return;
+    }
+
+    //Pulses are zero before the frame of the first bin
+    //
+    Pulse pulseUp, pulseDown;
+    ConvolutePMTFFT(sdepUp, sdepDown, firstBin, lastBin, pulseUp, pulseDown);
+    const auto first = Binning::GetFrame(firstBin);
+    maxUp = *(std::max_element(pulseUp.begin() + first, pulseUp.end()));
+    maxDown = *(std::max_element(pulseDown.begin() + first, pulseDown.end()));
+
+}
+
+//ConvolutePMTFFT() method
+//The PMT response is real, so the real and imaginary parts
+//of the packed signal are convoluted independently
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::ConvolutePMTFFT( const Value* sdepUp, const Value* sdepDown,
+                                                      std::size_t firstBin, std::size_t lastBin,
+                                                      Pulse& pulseUp, Pulse& pulseDown ) const {
+
+    std::fill(fWorkspace.begin(), fWorkspace.end(), 0.);
+    for ( std::size_t n = firstBin; n <= lastBin; ++n ) {
+        fWorkspace[Binning::GetFrame(n)] = std::complex<G4double>(sdepUp[n], sdepDown[n]);
+    }
+
+    FFT(fWorkspace, false);
+    for ( std::size_t n = 0; n < fFFTSize; ++n ) { fWorkspace[n] *= fResponseSpectrum[n]; }
+    FFT(fWorkspace, true);
+
+    //Nothing can be there before the frame of the first bin
+    //
+    const auto first = Binning::GetFrame(firstBin);
+    std::fill(pulseUp.begin(), pulseUp.begin() + first, 0.);
+    std::fill(pulseDown.begin(), pulseDown.begin() + first, 0.);
+    for ( std::size_t n = first; n < Binning::windowFrames; ++n ) {
+        pulseUp[n] = fWorkspace[n].real();
+        pulseDown[n] = fWorkspace[n].imag();
+    }
+
+}
+
+//ConvolutePMTSparse() method
+//Scatter form: each entry adds a shifted and scaled copy of the PMT response
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::ConvolutePMTSparse( const std::vector<ATLTileCalTBHit::SdepEntry>& sdep,
+                                                         Pulse& pulseUp, Pulse& pulseDown ) {
+
+    constexpr auto pmt_response_size = ATLTileCalTBConstants::pmt_response.size();
+    pulseUp.fill(0.);
+    pulseDown.fill(0.);
+    for ( const auto& entry : sdep ) {
+        const auto frame = Binning::GetFrame(entry.frame);
+        const auto nSamples = std::min(pmt_response_size, Binning::windowFrames - frame);
+        G4double* up = pulseUp.data() + frame;
+        G4double* down = pulseDown.data() + frame;
+        for ( std::size_t j = 0; j < nSamples; ++j ) {
+            up[j] += entry.up * ATLTileCalTBConstants::pmt_response[j];
+            down[j] += entry.down * ATLTileCalTBConstants::pmt_response[j];
+        }
+    }
+
+}
+
+//AddToBatch() method
+//
+template <class Binning>
+std::size_t ATLTileCalTBDigitizer<Binning>::AddToBatch( const Value* sdep, std::size_t firstBin, std::size_t lastBin ) {
+
+    //Only the bins in range are stored
+    //
+    fBatchOffset.push_back(fBatchSdep.size());
+    if ( firstBin <= lastBin ) fBatchSdep.insert(fBatchSdep.end(), sdep + firstBin, sdep + lastBin + 1);
+    fBatchFirst.push_back(firstBin);
+    fBatchLast.push_back(lastBin);
+    return fBatchFirst.size() - 1;
+
+}
+
+//ClearBatch() method
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::ClearBatch() {
+
+    fBatchSdep.clear();
+    fBatchOffset.clear();
+    fBatchFirst.clear();
+    fBatchLast.clear();
+    fBatchMax.clear();
+
+}
+
+//ConvoluteBatch() method
+//Pulse = T x S, with T the (frames x bins) banded matrix of the PMT response
+//(lower-triangular Toeplitz with uniform bins) and S the (bins x channels)
+//matrix of the signals.
+//The product is done tile by tile so that the panel of S stays in cache.
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::ConvoluteBatch() {
+
+    fBatchMax.assign(GetBatchSize(), 0.);
+    fBatchOrder.resize(GetBatchSize());
+    std::iota(fBatchOrder.begin(), fBatchOrder.end(), 0);
+    std::sort(fBatchOrder.begin(), fBatchOrder.end(), [this]( std::size_t a, std::size_t b ) {
+        return std::tie(fBatchLast[a], fBatchFirst[a]) < std::tie(fBatchLast[b], fBatchFirst[b]);
+    });
+    for ( std::size_t i = 0; i < GetBatchSize(); i += fBatchChannels ) {
+        ConvoluteBatchTile(fBatchOrder.data() + i, std::min(fBatchChannels, GetBatchSize() - i));
+    }
+
+}
+
+//ConvoluteBatchTile() method
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::ConvoluteBatchTile( const std::size_t* channels, std::size_t nChannels ) {
+
+    constexpr auto frames = Binning::windowFrames;
+    constexpr auto pmt_response_size = ATLTileCalTBConstants::pmt_response.size();
+
+    //Bins spanned by the tile, channels are zero outside of their own range
+    //
+    std::size_t first = SIZE_MAX;
+    std::size_t last = 0;
+    std::array<std::size_t, fBatchChannels> channelFirst;
+    channelFirst.fill(SIZE_MAX);
+    for ( std::size_t c = 0; c < nChannels; ++c ) {
+        channelFirst[c] = Binning::GetFrame(fBatchFirst[channels[c]]);
+        first = std::min(first, fBatchFirst[channels[c]]);
+        last = std::max(last, fBatchLast[channels[c]]);
+    }
+    if ( first > last ) return;
+    const auto end = std::min(frames, Binning::GetFrame(last) + pmt_response_size);
+
+    //Transpose the signals into a bin-major panel (missing channels are zero)
+    //
+    std::fill(fBatchPanel.begin() + first * fBatchChannels, fBatchPanel.begin() + (last + 1) * fBatchChannels, 0.);
+    for ( std::size_t c = 0; c < nChannels; ++c ) {
+        const G4double* sdep = fBatchSdep.data() + fBatchOffset[channels[c]];
+        for ( std::size_t n = fBatchFirst[channels[c]]; n <= fBatchLast[channels[c]]; ++n ) {
+            fBatchPanel[n * fBatchChannels + c] = *(sdep++);
+        }
+    }
+
+    //Pulses are zero after the response of the last bin of each channel
+    //
+    std::array<G4double, fBatchChannels> channelMax;
+    channelMax.fill((end < frames) ? 0. : std::numeric_limits<G4double>::lowest());
+
+    //Each block of output frames accumulates the band of bins reaching it
+    //
+    alignas(64) BatchBlock acc;
+    for ( std::size_t k0 = Binning::GetFrame(first); k0 < end; k0 += fBatchRows ) {
+        const auto k = static_cast<std::ptrdiff_t>(k0);
+        const auto nmin = std::max(first, static_cast<std::size_t>(
+            Binning::GetFirstBin(k - static_cast<std::ptrdiff_t>(pmt_response_size) + 1)));
+        const auto nmax = std::min(last, static_cast<std::size_t>(
+            Binning::GetLastBin(k + static_cast<std::ptrdiff_t>(fBatchRows) - 1)));
+        switch ( fKernel.GetISA() ) {
+            #ifdef ATLTileCalTB_X86KERNELS
+            case Kernel::ISA::AVX512:
+                AccumulateBlockAVX512(k0, nmin, nmax, acc);
+                break;
+            case Kernel::ISA::AVX2:
+                AccumulateBlockAVX2(k0, nmin, nmax, acc);
+                break;
+            #endif
+            default:
+                AccumulateBlock(k0, nmin, nmax, acc);
+                break;
+        }
+        for ( std::size_t kk = 0; kk < fBatchRows && k0 + kk < end; ++kk ) {
+            for ( std::size_t c = 0; c < fBatchChannels; ++c ) {
+                if ( k0 + kk >= channelFirst[c] ) channelMax[c] = std::max(channelMax[c], acc[kk][c]);
+            }
+        }
+    }
+
+    for ( std::size_t c = 0; c < nChannels; ++c ) { fBatchMax[channels[c]] = channelMax[c]; }
+
+}
+
+//AccumulateBlock() method
+//BatchResponse(k0, n)[kk] is zero for k0 + kk - (frame of n) outside of the response
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::AccumulateBlock( std::size_t k0, std::size_t nmin, std::size_t nmax,
+                                                      BatchBlock& acc ) const {
+
+    for ( auto& row : acc ) { std::fill(std::begin(row), std::end(row), 0.); }
+    for ( std::size_t n = nmin; n <= nmax; ++n ) {
+        const G4double* panel = fBatchPanel.data() + n * fBatchChannels;
+        const G4double* response = BatchResponse(k0, n);
+        for ( std::size_t kk = 0; kk < fBatchRows; ++kk ) {
+            for ( std::size_t c = 0; c < fBatchChannels; ++c ) {
+                acc[kk][c] += response[kk] * panel[c];
+            }
+        }
+    }
+
+}
+
+#ifdef ATLTileCalTB_X86KERNELS
+
+//AccumulateBlockAVX2() method
+//Two halves of eight channels, 4 rows x 2 vectors of accumulators each
+//
+template <class Binning>
+__attribute__((target("avx2,fma")))
+void ATLTileCalTBDigitizer<Binning>::AccumulateBlockAVX2( std::size_t k0, std::size_t nmin, std::size_t nmax,
+                                                          BatchBlock& acc ) const {
+
+    static_assert(fBatchRows == 4 && fBatchChannels == 16, "AVX2 block assumes 4 x 16 tiles");
+    for ( std::size_t half = 0; half < fBatchChannels; half += 8 ) {
+        __m256d acc00 = _mm256_setzero_pd(), acc01 = _mm256_setzero_pd();
+        __m256d acc10 = _mm256_setzero_pd(), acc11 = _mm256_setzero_pd();
+        __m256d acc20 = _mm256_setzero_pd(), acc21 = _mm256_setzero_pd();
+        __m256d acc30 = _mm256_setzero_pd(), acc31 = _mm256_setzero_pd();
+        for ( std::size_t n = nmin; n <= nmax; ++n ) {
+            const G4double* panel = fBatchPanel.data() + n * fBatchChannels + half;
+            const G4double* response = BatchResponse(k0, n);
+            const __m256d s0 = _mm256_loadu_pd(panel);
+            const __m256d s1 = _mm256_loadu_pd(panel + 4);
+            __m256d r = _mm256_broadcast_sd(response);
+            acc00 = _mm256_fmadd_pd(r, s0, acc00); acc01 = _mm256_fmadd_pd(r, s1, acc01);
+            r = _mm256_broadcast_sd(response + 1);
+            acc10 = _mm256_fmadd_pd(r, s0, acc10); acc11 = _mm256_fmadd_pd(r, s1, acc11);
+            r = _mm256_broadcast_sd(response + 2);
+            acc20 = _mm256_fmadd_pd(r, s0, acc20); acc21 = _mm256_fmadd_pd(r, s1, acc21);
+            r = _mm256_broadcast_sd(response + 3);
+            acc30 = _mm256_fmadd_pd(r, s0, acc30); acc31 = _mm256_fmadd_pd(r, s1, acc31);
+        }
+        _mm256_storeu_pd(acc[0] + half, acc00); _mm256_storeu_pd(acc[0] + half + 4, acc01);
+        _mm256_storeu_pd(acc[1] + half, acc10); _mm256_storeu_pd(acc[1] + half + 4, acc11);
+        _mm256_storeu_pd(acc[2] + half, acc20); _mm256_storeu_pd(acc[2] + half + 4, acc21);
+        _mm256_storeu_pd(acc[3] + half, acc30); _mm256_storeu_pd(acc[3] + half + 4, acc31);
+    }
+
+}
+
+//AccumulateBlockAVX512() method
+//4 rows x 2 vectors of accumulators
+//
+template <class Binning>
+__attribute__((target("avx512f")))
+void ATLTileCalTBDigitizer<Binning>::AccumulateBlockAVX512( std::size_t k0, std::size_t nmin, std::size_t nmax,
+                                                            BatchBlock& acc ) const {
+
+    static_assert(fBatchRows == 4 && fBatchChannels == 16, "AVX-512 block assumes 4 x 16 tiles");
+    __m512d acc00 = _mm512_setzero_pd(), acc01 = _mm512_setzero_pd();
+    __m512d acc10 = _mm512_setzero_pd(), acc11 = _mm512_setzero_pd();
+    __m512d acc20 = _mm512_setzero_pd(), acc21 = _mm512_setzero_pd();
+    __m512d acc30 = _mm512_setzero_pd(), acc31 = _mm512_setzero_pd();
+    for ( std::size_t n = nmin; n <= nmax; ++n ) {
+        const G4double* panel = fBatchPanel.data() + n * fBatchChannels;
+        const G4double* response = BatchResponse(k0, n);
+        const __m512d s0 = _mm512_loadu_pd(panel);
+        const __m512d s1 = _mm512_loadu_pd(panel + 8);
+        __m512d r = _mm512_set1_pd(response[0]);
+        acc00 = _mm512_fmadd_pd(r, s0, acc00); acc01 = _mm512_fmadd_pd(r, s1, acc01);
+        r = _mm512_set1_pd(response[1]);
+        acc10 = _mm512_fmadd_pd(r, s0, acc10); acc11 = _mm512_fmadd_pd(r, s1, acc11);
+        r = _mm512_set1_pd(response[2]);
+        acc20 = _mm512_fmadd_pd(r, s0, acc20); acc21 = _mm512_fmadd_pd(r, s1, acc21);
+        r = _mm512_set1_pd(response[3]);
+        acc30 = _mm512_fmadd_pd(r, s0, acc30); acc31 = _mm512_fmadd_pd(r, s1, acc31);
+    }
+    _mm512_storeu_pd(acc[0], acc00); _mm512_storeu_pd(acc[0] + 8, acc01);
+    _mm512_storeu_pd(acc[1], acc10); _mm512_storeu_pd(acc[1] + 8, acc11);
+    _mm512_storeu_pd(acc[2], acc20); _mm512_storeu_pd(acc[2] + 8, acc21);
+    _mm512_storeu_pd(acc[3], acc30); _mm512_storeu_pd(acc[3] + 8, acc31);
+
+}
+
+#endif //ATLTileCalTB_X86KERNELS
+
+//SamplePMT() method
+//Convolution evaluated only at the sampling frames
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::SamplePMT( const Value* sdepUp, const Value* sdepDown,
+                                                std::size_t firstBin, std::size_t lastBin,
+                                                Samples& samplesUp, Samples& samplesDown ) const {
+
+    constexpr auto pmt_response_size = static_cast<std::ptrdiff_t>(ATLTileCalTBConstants::pmt_response.size());
+    samplesUp.fill(0.);
+    samplesDown.fill(0.);
+    if ( firstBin > lastBin ) return;
+    for ( std::size_t i = 0; i < fOFFrames.size(); ++i ) {
+        const auto k = static_cast<std::ptrdiff_t>(fOFFrames[i]);
+        const auto nmin = std::max(static_cast<std::ptrdiff_t>(firstBin), Binning::GetFirstBin(k - pmt_response_size + 1));
+        const auto nmax = std::min(static_cast<std::ptrdiff_t>(lastBin), Binning::GetLastBin(k));
+        for ( auto n = nmin; n <= nmax; ++n ) {
+            const auto response = ATLTileCalTBConstants::pmt_response[fOFFrames[i] - Binning::GetFrame(n)];
+            samplesUp[i] += sdepUp[n] * response;
+            samplesDown[i] += sdepDown[n] * response;
+        }
+    }
+
+}
+
+//SamplePMTSparse() method
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::SamplePMTSparse( const std::vector<ATLTileCalTBHit::SdepEntry>& sdep,
+                                                      Samples& samplesUp, Samples& samplesDown ) const {
+
+    constexpr auto pmt_response_size = ATLTileCalTBConstants::pmt_response.size();
+    samplesUp.fill(0.);
+    samplesDown.fill(0.);
+    for ( const auto& entry : sdep ) {
+        const auto frame = Binning::GetFrame(entry.frame);
+        for ( std::size_t i = 0; i < fOFFrames.size(); ++i ) {
+            if ( fOFFrames[i] < frame || fOFFrames[i] - frame >= pmt_response_size ) continue;
+            const auto response = ATLTileCalTBConstants::pmt_response[fOFFrames[i] - frame];
+            samplesUp[i] += entry.up * response;
+            samplesDown[i] += entry.down * response;
+        }
+    }
+
+}
+
+//ConvolutePMTDirect() method
+//From https://gitlab.cern.ch/allpix-squared/allpix-squared/-/blob/86fe21ad37d353e36a509a0827562ab7fadd5104/src/modules/CSADigitizer/CSADigitizerModule.cpp#L271-L283
+//Each bin contributes from its frame
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::ConvolutePMTDirect( const Value* sdep, Pulse& pulse ) {
+
+    constexpr auto pmt_response_size = static_cast<std::ptrdiff_t>(ATLTileCalTBConstants::pmt_response.size());
+    constexpr auto bins = static_cast<std::ptrdiff_t>(Binning::bins);
+    for (std::size_t k = 0; k < pulse.size(); ++k) {
+        G4double outsum = 0.;
+        const auto frame = static_cast<std::ptrdiff_t>(k);
+        const auto nmax = std::min(bins - 1, Binning::GetLastBin(frame));
+        for (auto n = Binning::GetFirstBin(frame - pmt_response_size + 1); n <= nmax; ++n) {
+            outsum += sdep[n] * ATLTileCalTBConstants::pmt_response[k - Binning::GetFrame(n)];
+        }
+        pulse[k] = outsum;
+    }
+
+}
+
+namespace {
+    //A failed benchmark check aborts the run
+    //
+    void CheckBenchmark( G4bool passed, const G4String& check ) {
+        if ( passed ) return;
+        G4ExceptionDescription msg;
+        msg << "Digitization benchmark check failed: " << check << G4endl;
+        G4Exception("ATLTileCalTBDigitizer::Benchmark()",
+        "MyCode0015", FatalException, msg);
+    }
+}
+
+//Benchmark() method
+//Uses its own random engine to leave the Geant4 random sequence untouched
+//
+template <class Binning>
+void ATLTileCalTBDigitizer<Binning>::Benchmark( std::size_t nPulses ) const {
+
+    //Shower-like test signals: prompt photoelectrons plus a sparse late tail,
+    //deposited step by step as in the sensitive detector (frame is the bin)
+    //
+    struct Step { std::size_t frame; G4double up, down; };
+    constexpr std::size_t stepsPerFrame = 20;
+    std::mt19937_64 engine(12345);
+    std::poisson_distribution<int> prompt(1.);
+    std::uniform_int_distribution<std::size_t> late(0, Binning::bins - 1);
+    std::uniform_real_distribution<G4double> ushape(0.3, 0.8);
+    std::vector<std::vector<Step>> steps(nPulses);
+    std::vector<std::size_t> firstFrame(nPulses), lastFrame(nPulses);
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        firstFrame[i] = 10;
+        lastFrame[i] = 59;
+        for ( std::size_t n = 10; n < 60; ++n ) {
+            for ( std::size_t k = 0; k < stepsPerFrame; ++k ) {
+                auto pe = static_cast<G4double>(prompt(engine));
+                steps[i].push_back({n, pe * ushape(engine), pe * ushape(engine)});
+            }
+        }
+        //Half of the cells get a late tail, the others stay short
+        for ( std::size_t n = 0; n < 20 && i % 2 == 0; ++n ) {
+            auto frame = late(engine);
+            steps[i].push_back({frame, ushape(engine), ushape(engine)});
+            firstFrame[i] = std::min(firstFrame[i], frame);
+            lastFrame[i] = std::max(lastFrame[i], frame);
+        }
+    }
+
+    //Per-step accumulation in the hit storage type and in single and
+    //double precision, the deviation of the single precision Sdep (peak)
+    //is bounded by the relative rounding of stepsPerFrame additions
+    //
+    std::vector<Signal> sdepUp(nPulses), sdepDown(nPulses);
+    std::vector<std::array<G4double, Binning::bins>> exactUp(nPulses), exactDown(nPulses);
+    std::vector<std::array<float, Binning::bins>> floatUp(nPulses), floatDown(nPulses);
+    auto start = std::chrono::steady_clock::now();
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        sdepUp[i].fill(0.);
+        sdepDown[i].fill(0.);
+        for ( const auto& step : steps[i] ) {
+            sdepUp[i][step.frame] += static_cast<ATLTileCalTBHit::SdepValue>(step.up);
+            sdepDown[i][step.frame] += static_cast<ATLTileCalTBHit::SdepValue>(step.down);
+        }
+    }
+    auto storageTime = std::chrono::duration<G4double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        floatUp[i].fill(0.f);
+        floatDown[i].fill(0.f);
+        for ( const auto& step : steps[i] ) {
+            floatUp[i][step.frame] += static_cast<float>(step.up);
+            floatDown[i][step.frame] += static_cast<float>(step.down);
+        }
+    }
+    auto floatTime = std::chrono::duration<G4double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        exactUp[i].fill(0.);
+        exactDown[i].fill(0.);
+        for ( const auto& step : steps[i] ) {
+            exactUp[i][step.frame] += step.up;
+            exactDown[i][step.frame] += step.down;
+        }
+    }
+    auto doubleTime = std::chrono::duration<G4double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    //Sdep of each accumulation from the direct convolution in double precision
+    //
+    auto peak = []( const auto& signal ) {
+        constexpr auto pmt_response_size = static_cast<std::ptrdiff_t>(ATLTileCalTBConstants::pmt_response.size());
+        G4double max = 0.;
+        for ( std::size_t k = 0; k < Binning::windowFrames; ++k ) {
+            G4double sum = 0.;
+            const auto frame = static_cast<std::ptrdiff_t>(k);
+            const auto nmax = std::min(static_cast<std::ptrdiff_t>(Binning::bins) - 1, Binning::GetLastBin(frame));
+            for ( auto n = Binning::GetFirstBin(frame - pmt_response_size + 1); n <= nmax; ++n ) {
+                sum += static_cast<G4double>(signal[n]) * ATLTileCalTBConstants::pmt_response[k - Binning::GetFrame(n)];
+            }
+            max = std::max(max, sum);
+        }
+        return max;
+    };
+    G4double maxFloatDeviation = 0., meanFloatDeviation = 0.;
+    G4double maxStorageDeviation = 0.;
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        for ( auto [exact, single, stored] : { std::tie(exactUp[i], floatUp[i], sdepUp[i]),
+                                               std::tie(exactDown[i], floatDown[i], sdepDown[i]) } ) {
+            const G4double reference = peak(exact);
+            const G4double floatDeviation = std::abs(peak(single) - reference) / reference;
+            maxFloatDeviation = std::max(maxFloatDeviation, floatDeviation);
+            meanFloatDeviation += floatDeviation / static_cast<G4double>(2 * nPulses);
+            maxStorageDeviation = std::max(maxStorageDeviation, std::abs(peak(stored) - reference) / reference);
+        }
+    }
+
+    Pulse pulseUp, pulseDown, referenceUp, referenceDown;
+    G4double maxReference = 0.;
+    G4double maxDeviation = 0.;
+    G4double maxSparseDeviation = 0.;
+    G4double checksum = 0.;
+
+    start = std::chrono::steady_clock::now();
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        ConvolutePMTDirect(sdepUp[i].data(), referenceUp);
+        ConvolutePMTDirect(sdepDown[i].data(), referenceDown);
+        checksum += referenceUp[200] + referenceDown[200];
+    }
+    auto directTime = std::chrono::duration<G4double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        ConvolutePMT(sdepUp[i].data(), sdepDown[i].data(), firstFrame[i], lastFrame[i], pulseUp, pulseDown);
+        checksum -= pulseUp[200] + pulseDown[200];
+    }
+    auto fftTime = std::chrono::duration<G4double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    //Same signals in the sparse layout
+    //
+    std::vector<std::vector<ATLTileCalTBHit::SdepEntry>> sdepSparse(nPulses);
+    std::size_t nEntries = 0;
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        for ( std::size_t n = 0; n < Binning::bins; ++n ) {
+            if ( sdepUp[i][n] != 0. || sdepDown[i][n] != 0. ) {
+                sdepSparse[i].push_back({static_cast<std::uint32_t>(n), sdepUp[i][n], sdepDown[i][n]});
+            }
+        }
+        nEntries += sdepSparse[i].size();
+    }
+
+    start = std::chrono::steady_clock::now();
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        ConvolutePMTSparse(sdepSparse[i], pulseUp, pulseDown);
+        checksum -= pulseUp[200] + pulseDown[200];
+    }
+    auto sparseTime = std::chrono::duration<G4double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        ConvolutePMTDirect(sdepUp[i].data(), referenceUp);
+        ConvolutePMTDirect(sdepDown[i].data(), referenceDown);
+        maxReference = std::max({maxReference, *(std::max_element(referenceUp.begin(), referenceUp.end())),
+                                 *(std::max_element(referenceDown.begin(), referenceDown.end()))});
+        ConvolutePMT(sdepUp[i].data(), sdepDown[i].data(), firstFrame[i], lastFrame[i], pulseUp, pulseDown);
+        for ( std::size_t n = 0; n < Binning::windowFrames; ++n ) {
+            maxDeviation = std::max(maxDeviation, std::abs(pulseUp[n] - referenceUp[n]));
+            maxDeviation = std::max(maxDeviation, std::abs(pulseDown[n] - referenceDown[n]));
+        }
+        ConvolutePMTSparse(sdepSparse[i], pulseUp, pulseDown);
+        for ( std::size_t n = 0; n < Binning::windowFrames; ++n ) {
+            maxSparseDeviation = std::max(maxSparseDeviation, std::abs(pulseUp[n] - referenceUp[n]));
+            maxSparseDeviation = std::max(maxSparseDeviation, std::abs(pulseDown[n] - referenceDown[n]));
+        }
+    }
+
+    G4cout << " ====================================================================== " << G4endl;
+    G4cout << "  Digitization benchmark (" << nPulses << " cells, up and down PMTs, " << Binning::bins
+           << " bins per PMT, " << Binning::windowFrames << " frames per pulse)" << G4endl;
+    G4cout << "  Per-step accumulation (" << steps.front().size() << " steps/cell, us/cell): double "
+           << doubleTime / static_cast<G4double>(nPulses) << ", single " << floatTime / static_cast<G4double>(nPulses) << G4endl;
+    G4cout << "  Single precision Sdep relative deviation vs double: max " << maxFloatDeviation
+           << ", mean " << meanFloatDeviation << G4endl;
+    G4cout << "  Hit storage (" << 2 * sizeof(Signal) << " bytes/cell, us/cell " << storageTime / static_cast<G4double>(nPulses)
+           << "): max relative Sdep deviation vs double " << maxStorageDeviation << G4endl;
+    G4cout << "  Direct convolution (us/cell): " << directTime / static_cast<G4double>(nPulses) << G4endl;
+    G4cout << "  Dispatched convolution (us/cell, " << Kernel::GetISAName(fKernel.GetISA()) << "): " << fftTime / static_cast<G4double>(nPulses) << G4endl;
+    G4cout << "  Speed-up: " << directTime / fftTime << G4endl;
+    G4cout << "  Max deviation vs direct: " << maxDeviation << G4endl;
+    G4cout << "  Sparse convolution (us/cell, " << static_cast<G4double>(nEntries) / static_cast<G4double>(nPulses)
+           << " entries/cell): " << sparseTime / static_cast<G4double>(nPulses) << G4endl;
+    G4cout << "  Speed-up: " << directTime / sparseTime << G4endl;
+    G4cout << "  Max deviation vs direct: " << maxSparseDeviation << G4endl;
+
+    //The kernels only differ from the direct convolution by the order
+    //of the additions, the accumulations by the rounding of their type
+    //
+    const G4double maxAllowedDeviation = fBenchmarkTolerance * maxReference;
+    CheckBenchmark( maxFloatDeviation <= stepsPerFrame * std::numeric_limits<float>::epsilon(),
+                    "single precision accumulation above the rounding of its additions" );
+    CheckBenchmark( maxStorageDeviation <= stepsPerFrame * std::numeric_limits<ATLTileCalTBHit::SdepValue>::epsilon(),
+                    "hit storage accumulation above the rounding of its additions" );
+    CheckBenchmark( maxDeviation <= maxAllowedDeviation, "dispatched convolution deviates from the direct one" );
+    CheckBenchmark( maxSparseDeviation <= maxAllowedDeviation, "sparse convolution deviates from the direct one" );
+
+    //Fused convolution and peak finding for every instruction set of this CPU,
+    //checked against the maximum of the direct convolution
+    //
+    for ( auto isa : { Kernel::ISA::Scalar, Kernel::ISA::SSE42, Kernel::ISA::AVX2, Kernel::ISA::AVX512 } ) {
+        if ( isa > Kernel::GetBestISA() ) break;
+        Kernel kernel(ATLTileCalTBConstants::pmt_response, isa);
+        G4double maxUp, maxDown;
+
+        start = std::chrono::steady_clock::now();
+        for ( std::size_t i = 0; i < nPulses; ++i ) {
+            kernel.ConvoluteMax(sdepUp[i].data(), sdepDown[i].data(), firstFrame[i], lastFrame[i], maxUp, maxDown);
+            checksum -= maxUp + maxDown;
+        }
+        auto kernelTime = std::chrono::duration<G4double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        G4double maxPeakDeviation = 0.;
+        for ( std::size_t i = 0; i < nPulses; ++i ) {
+            ConvolutePMTDirect(sdepUp[i].data(), referenceUp);
+            ConvolutePMTDirect(sdepDown[i].data(), referenceDown);
+            kernel.ConvoluteMax(sdepUp[i].data(), sdepDown[i].data(), firstFrame[i], lastFrame[i], maxUp, maxDown);
+            const auto first = Binning::GetFrame(firstFrame[i]);
+            maxPeakDeviation = std::max(maxPeakDeviation,
+                std::abs(maxUp - *(std::max_element(referenceUp.begin() + first, referenceUp.end()))));
+            maxPeakDeviation = std::max(maxPeakDeviation,
+                std::abs(maxDown - *(std::max_element(referenceDown.begin() + first, referenceDown.end()))));
+        }
+
+        G4cout << "  Fused " << Kernel::GetISAName(isa) << " convolution and peak (us/cell): "
+               << kernelTime / static_cast<G4double>(nPulses) << G4endl;
+        G4cout << "  Speed-up: " << directTime / kernelTime << G4endl;
+        G4cout << "  Max peak deviation vs direct: " << maxPeakDeviation << G4endl;
+        CheckBenchmark( maxPeakDeviation <= maxAllowedDeviation,
+                        "fused " + G4String(Kernel::GetISAName(isa)) + " peak deviates from the direct one" );
+    }
+
+    //Batched product over all the channels
+    //
+    ATLTileCalTBDigitizer batch;
+    G4double batchTime = 0.;
+    for ( std::size_t pass = 0; pass < 2; ++pass ) { //first pass allocates the buffers
+        batch.ClearBatch();
+        start = std::chrono::steady_clock::now();
+        for ( std::size_t i = 0; i < nPulses; ++i ) {
+            batch.AddToBatch(sdepUp[i].data(), firstFrame[i], lastFrame[i]);
+            batch.AddToBatch(sdepDown[i].data(), firstFrame[i], lastFrame[i]);
+        }
+        batch.ConvoluteBatch();
+        batchTime = std::chrono::duration<G4double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    G4double maxBatchDeviation = 0.;
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        ConvolutePMTDirect(sdepUp[i].data(), referenceUp);
+        ConvolutePMTDirect(sdepDown[i].data(), referenceDown);
+        const auto first = Binning::GetFrame(firstFrame[i]);
+        maxBatchDeviation = std::max(maxBatchDeviation,
+            std::abs(batch.GetBatchMax(2 * i) - *(std::max_element(referenceUp.begin() + first, referenceUp.end()))));
+        maxBatchDeviation = std::max(maxBatchDeviation,
+            std::abs(batch.GetBatchMax(2 * i + 1) - *(std::max_element(referenceDown.begin() + first, referenceDown.end()))));
+    }
+    G4cout << "  Batched Toeplitz product and peak (us/cell): " << batchTime / static_cast<G4double>(nPulses) << G4endl;
+    G4cout << "  Speed-up: " << directTime / batchTime << G4endl;
+    G4cout << "  Max peak deviation vs direct: " << maxBatchDeviation << G4endl;
+    CheckBenchmark( maxBatchDeviation <= maxAllowedDeviation, "batched peak deviates from the direct one" );
+
+    //Optimal filtering, the amplitude estimates the peak of the pulse
+    //
+    Samples samplesUp, samplesDown;
+    G4double ofRatio = 0.;
+    start = std::chrono::steady_clock::now();
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        SamplePMT(sdepUp[i].data(), sdepDown[i].data(), firstFrame[i], lastFrame[i], samplesUp, samplesDown);
+        checksum -= GetOFAmplitude(samplesUp) + GetOFAmplitude(samplesDown);
+    }
+    auto ofTime = std::chrono::duration<G4double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    for ( std::size_t i = 0; i < nPulses; ++i ) {
+        ConvolutePMTDirect(sdepUp[i].data(), referenceUp);
+        SamplePMT(sdepUp[i].data(), sdepDown[i].data(), firstFrame[i], lastFrame[i], samplesUp, samplesDown);
+        ofRatio += GetOFAmplitude(samplesUp) / *(std::max_element(referenceUp.begin(), referenceUp.end()));
+    }
+    G4cout << "  Optimal filtering, 7 samples (us/cell): " << ofTime / static_cast<G4double>(nPulses) << G4endl;
+    G4cout << "  Speed-up: " << directTime / ofTime << G4endl;
+    G4cout << "  Mean OF amplitude / peak: " << ofRatio / static_cast<G4double>(nPulses) << G4endl;
+    #ifdef ATLTileCalTB_SparseHits
+    //Interleaved tracks alternate their deposits between frames, the
+    //coalesced hit must hold one entry per frame with the summed signal
+    //
+    ATLTileCalTBHit interleavedHit;
+    constexpr std::size_t nInterleavedFrames = 5;
+    constexpr std::size_t nInterleavedSteps = 100;
+    for ( std::size_t step = 0; step < nInterleavedSteps; ++step ) {
+        interleavedHit.AddSdep( 10 + 7 * (step % nInterleavedFrames), 1., 0.5 );
+    }
+    interleavedHit.Coalesce();
+    const auto& entries = interleavedHit.GetSdepEntries();
+    G4bool coalesced = entries.size() == nInterleavedFrames;
+    for ( std::size_t i = 0; coalesced && i < entries.size(); ++i ) {
+        coalesced = entries[i].frame == 10 + 7 * i
+                    && entries[i].up == static_cast<ATLTileCalTBHit::SdepValue>(nInterleavedSteps / nInterleavedFrames)
+                    && entries[i].down == static_cast<ATLTileCalTBHit::SdepValue>(0.5 * nInterleavedSteps / nInterleavedFrames);
+    }
+    G4cout << "  Interleaved sparse deposits: " << nInterleavedSteps << " steps in " << nInterleavedFrames
+           << " frames coalesced in " << entries.size() << " entries" << G4endl;
+    CheckBenchmark( coalesced, "sparse hit entries are not coalesced per frame" );
+    #endif
+    G4cout << "  (checksum " << checksum << ")" << G4endl;
+    G4cout << " ====================================================================== " << G4endl;
+
+}
+
+//Digitizers of the binnings of ATLTileCalTBBinnings::List
+//
+template class ATLTileCalTBDigitizer<ATLTileCalTBBinnings::Window350>;
+template class ATLTileCalTBDigitizer<ATLTileCalTBBinnings::Window200>;
+template class ATLTileCalTBDigitizer<ATLTileCalTBBinnings::Window350Tail5>;
+template class ATLTileCalTBDigitizer<ATLTileCalTBBinnings::Window200Tail5>;
+
+//**************************************************
@@ -0,0 +1,189 @@
+//**************************************************
+// \file ATLTileCalTBEMShowerModel.cc
+// \brief: implementation of ATLTileCalTBEMShowerModel
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+#ifdef ATLTileCalTB_FastSim
+
+//Includers from project files
+//
+#include "ATLTileCalTBEMShowerModel.hh"
+#include "ATLTileCalTBEMShowerParameters.hh"
+
+//Includers from Geant4
+//
+#include "G4FastHit.hh"
+#include "G4FastSimHitMaker.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4Electron.hh"
+#include "G4Gamma.hh"
+#include "G4Positron.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+//Includers from C++
+//
+#include <algorithm>
+#include <cmath>
+
+//Constructor and de-constructor
+//The model is built per thread, the parameters are shared
+//
+ATLTileCalTBEMShowerModel::ATLTileCalTBEMShowerModel( const G4String& name )
+    : G4VFastSimulationModel(name),
+      fParameters(ATLTileCalTBEMShowerParameters::GetInstance()),
+      fHitMaker(new G4FastSimHitMaker) {}
+
+ATLTileCalTBEMShowerModel::~ATLTileCalTBEMShowerModel() {
+    delete fHitMaker;
+}
+
+//IsApplicable base method
+//
+G4bool ATLTileCalTBEMShowerModel::IsApplicable( const G4ParticleDefinition& particle ) {
+    return &particle == G4Electron::ElectronDefinition()
+        || &particle == G4Positron::PositronDefinition()
+        || &particle == G4Gamma::GammaDefinition();
+}
+
+//ModelTrigger base method
+//Showers below the threshold or outside of the parameterization
+//are left to the full simulation
+//
+G4bool ATLTileCalTBEMShowerModel::ModelTrigger( const G4FastTrack& fastTrack ) {
+    if ( !fParameters->IsEnabled() ) return false;
+    const auto track = fastTrack.GetPrimaryTrack();
+    const auto energy = track->GetKineticEnergy();
+    if ( energy < fParameters->GetMinEnergy() ) return false;
+    ProfileDistribution distribution;
+    return GetProfileDistribution( energy, track->GetParticleDefinition() == G4Gamma::GammaDefinition(), distribution );
+}
+
+//DoIt base method
+//
+void ATLTileCalTBEMShowerModel::DoIt( const G4FastTrack& fastTrack, G4FastStep& fastStep ) {
+
+    const auto track = fastTrack.GetPrimaryTrack();
+    const auto particle = track->GetParticleDefinition();
+    G4double energy = track->GetKineticEnergy();
+    //A positron annihilates at the end of the shower
+    if ( particle == G4Positron::PositronDefinition() ) energy += 2.*electron_mass_c2;
+
+    //The whole energy is deposited in this step, the hits are
+    //made by the spots
+    //
+    fastStep.KillPrimaryTrack();
+    fastStep.ProposePrimaryTrackPathLength( 0. );
+    fastStep.ProposeTotalEnergyDeposited( energy );
+
+    ProfileDistribution distribution;
+    GetProfileDistribution( energy, particle == G4Gamma::GammaDefinition(), distribution );
+    const auto profile = SampleLongitudinalProfile( distribution );
+
+    //Radial profile: core and tail distributions with radii
+    //(in units of RM) and core fraction varying with depth
+    //
+    const G4double lnE = std::log( energy/GeV );
+    const G4double Z = fParameters->GetEffectiveZ();
+    const G4double z1 = 0.0251 + 0.00319 * lnE;
+    const G4double z2 = 0.1162 - 0.000381 * Z;
+    const G4double k1 = 0.659 - 0.00309 * Z;
+    const G4double k2 = 0.645;
+    const G4double k3 = -2.59;
+    const G4double k4 = 0.3585 + 0.0412 * lnE;
+    const G4double p1 = 2.632 - 0.00094 * Z;
+    const G4double p2 = 0.401 + 0.00187 * Z;
+    const G4double p3 = 1.313 - 0.0686 * lnE;
+
+    const G4double radiationLength = fParameters->GetRadiationLength();
+    const G4double moliereRadius = fParameters->GetMoliereRadius();
+    const G4double scintillatorWeight = fParameters->GetScintillatorWeight();
+    const auto noOfSpots = static_cast<G4int>( std::max( 1., std::ceil( energy/fParameters->GetSpotEnergy() ) ) );
+    const G4double spotEnergy = energy/noOfSpots;
+
+    const auto position = track->GetPosition();
+    const auto direction = track->GetMomentumDirection();
+    const auto orthogonal1 = direction.orthogonal().unit();
+    const auto orthogonal2 = direction.cross( orthogonal1 );
+
+    for ( G4int i = 0; i < noOfSpots; ++i ) {
+        const G4double t = CLHEP::RandGamma::shoot( profile.alpha, profile.beta );
+        const G4double tau = t/profile.T;
+        const G4double coreRadius = z1 + z2 * tau;
+        const G4double tailRadius = k1 * ( std::exp( k3 * ( tau - k2 ) ) + std::exp( k4 * ( tau - k2 ) ) );
+        const G4double coreFraction = std::clamp( p1 * std::exp( ( p2 - tau )/p3 - std::exp( ( p2 - tau )/p3 ) ), 0., 1. );
+        const G4double radius = G4UniformRand() < coreFraction ? coreRadius : tailRadius;
+
+        //Cut at u = 0.99, i.e. 10 times the radius of the distribution
+        const G4double u = std::min( G4UniformRand(), 0.99 );
+        const G4double r = radius * std::sqrt( u/(1.-u) ) * moliereRadius;
+        const G4double phi = twopi * G4UniformRand();
+
+        const auto spotPosition = position + t * radiationLength * direction
+                                  + r * std::cos(phi) * orthogonal1 + r * std::sin(phi) * orthogonal2;
+        fHitMaker->make( G4FastHit( spotPosition, spotEnergy * scintillatorWeight ), fastTrack );
+    }
+
+}
+
+//GetProfileDistribution method
+//Homogeneous medium parameterization with the corrections of the
+//sampling frequency and e/mip of a sampling calorimeter
+//(Grindhammer and Peters, hep-ex/0001020)
+//
+G4bool ATLTileCalTBEMShowerModel::GetProfileDistribution( G4double energy, G4bool isGamma,
+                                                          ProfileDistribution& distribution ) const {
+    const G4double lny = std::log( energy/fParameters->GetCriticalEnergy() );
+    const G4double inverseFs = 1./fParameters->GetSamplingFrequency();
+    const G4double eHatCorrection = 1. - fParameters->GetEHat();
+
+    //Photons start their shower about half a radiation length deeper
+    const G4double T = lny - 0.812 + ( isGamma ? 0.5 : 0. ) - 0.59 * inverseFs - 0.53 * eHatCorrection;
+    const G4double alpha = 0.81 + ( 0.458 + 2.26/fParameters->GetEffectiveZ() ) * lny - 0.444 * inverseFs;
+    const G4double sigmaLnT = -2.5 + 1.25 * lny;
+    const G4double sigmaLnAlpha = -0.82 + 0.79 * lny;
+    if ( T <= 0. || alpha <= 1. || sigmaLnT <= 0. || sigmaLnAlpha <= 0. ) return false;
+
+    distribution.lnT = std::log( T );
+    distribution.lnAlpha = std::log( alpha );
+    distribution.sigmaLnT = 1./sigmaLnT;
+    distribution.sigmaLnAlpha = 1./sigmaLnAlpha;
+    distribution.correlation = std::clamp( 0.784 - 0.023 * lny, -1., 1. );
+    return true;
+}
+
+//SampleLongitudinalProfile method
+//Correlated log-normal depth and shape of a shower, the average
+//profile without fluctuations
+//
+ATLTileCalTBEMShowerModel::LongitudinalProfile ATLTileCalTBEMShowerModel::SampleLongitudinalProfile(
+    const ProfileDistribution& distribution ) const {
+
+    LongitudinalProfile profile;
+    profile.T = std::exp( distribution.lnT );
+    profile.alpha = std::exp( distribution.lnAlpha );
+    if ( fParameters->HasFluctuations() ) {
+        //Showers with alpha <= 1 have no maximum and are drawn again
+        do {
+            const G4double x1 = G4RandGauss::shoot();
+            const G4double x2 = G4RandGauss::shoot();
+            const G4double rho = distribution.correlation;
+            profile.T = std::exp( distribution.lnT + distribution.sigmaLnT * x1 );
+            profile.alpha = std::exp( distribution.lnAlpha + distribution.sigmaLnAlpha *
+                                      ( rho * x1 + std::sqrt( ( 1. - rho ) * ( 1. + rho ) ) * x2 ) );
+        } while ( profile.alpha <= 1. );
+    }
+    profile.beta = ( profile.alpha - 1. )/profile.T;
+    return profile;
+
+}
+
+#endif //ATLTileCalTB_FastSim
+
+//**************************************************
@@ -0,0 +1,218 @@
+//**************************************************
+// \file ATLTileCalTBEMShowerParameters.cc
+// \brief: implementation of ATLTileCalTBEMShowerParameters
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+#ifdef ATLTileCalTB_FastSim
+
+//Includers from project files
+//
+#include "ATLTileCalTBEMShowerParameters.hh"
+#include "ATLTileCalTBConstants.hh"
+#include "ATLTileCalTBGeometry.hh"
+
+//Includers from Geant4
+//
+#include "G4ios.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4Material.hh"
+
+//Includers from C++
+//
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+//GetInstance() method
+//One instance per process, configured by the master thread
+//
+ATLTileCalTBEMShowerParameters* ATLTileCalTBEMShowerParameters::GetInstance() {
+    static ATLTileCalTBEMShowerParameters instance;
+    return &instance;
+}
+
+//Constructor and de-constructor
+//
+ATLTileCalTBEMShowerParameters::ATLTileCalTBEMShowerParameters()
+    : fEnabled(false),
+      fMinEnergy(1.*GeV),
+      fSpotEnergy(10.*MeV),
+      fFluctuations(true),
+      fResponseScale(1.),
+      fUpdated(false),
+      fValid(false),
+      fRadiationLength(0.),
+      fMoliereRadius(0.),
+      fCriticalEnergy(0.),
+      fEffectiveZ(0.),
+      fSamplingFrequency(0.),
+      fEHat(0.),
+      fScintillatorWeight(0.) {
+
+    //Commands are only allowed between runs and not broadcasted,
+    //as the parameters are shared by all threads
+    //
+    fMessenger = new G4GenericMessenger(this, "/ATLTileCalTB/fastsim/", "EM shower fast simulation in the Tile modules");
+    fMessenger->DeclareProperty("enable", fEnabled,
+        "Parameterize the EM showers (false for the full simulation)")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclarePropertyWithUnit("minEnergy", "GeV", fMinEnergy,
+        "Only e+, e- and gamma above this energy are parameterized")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclarePropertyWithUnit("spotEnergy", "MeV", fSpotEnergy,
+        "Energy of each deposit of a parameterized shower")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclareProperty("fluctuations", fFluctuations,
+        "Sample the longitudinal profile of each shower (false for the average profile)")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclareProperty("responseScale", fResponseScale,
+        "Scale of the scintillator deposits, tuned against the full simulation with FastSimComparison.C")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+
+}
+
+ATLTileCalTBEMShowerParameters::~ATLTileCalTBEMShowerParameters() {
+    delete fMessenger;
+}
+
+//Update() method
+//The periods (iron, glue, wrappers and scintillators) are mixed by
+//volume: each material gets the volume of its logical volumes without
+//their daughters. Critical energies are from the PDG fit for solids.
+//The deposits in the scintillators are weighted to the sampling
+//fraction of the photoelectron calibration, with the Birks' law
+//quenching of the full simulation (ATLTileCalTBConstants), since the
+//sensitive detector applies neither to the fast hits.
+//
+void ATLTileCalTBEMShowerParameters::Update() {
+
+    if ( fUpdated ) return;
+    fUpdated = true;
+
+    struct Component {
+        const G4Material* material;
+        G4bool active;
+        G4double volume;
+    };
+    std::vector<Component> components;
+    G4double periodVolume = 0.;
+    G4double periodThickness = 0.;
+
+    using ATLTileCalTBGeometry::VolumeRole;
+    auto volumeRoles = ATLTileCalTBGeometry::VolumeRoleTable::GetInstance();
+    std::function<void(const G4LogicalVolume*, G4bool)> addVolume = [&]( const G4LogicalVolume* volume, G4bool active ) {
+        active = active || volumeRoles->HasAnyRole( volume, VolumeRole::Scintillator );
+        G4double ownVolume = volume->GetSolid()->GetCubicVolume();
+        for ( std::size_t i = 0; i < volume->GetNoDaughters(); ++i ) {
+            auto daughter = volume->GetDaughter(i)->GetLogicalVolume();
+            ownVolume -= daughter->GetSolid()->GetCubicVolume();
+            addVolume( daughter, active );
+        }
+        auto component = std::find_if( components.begin(), components.end(), [&]( const Component& c ) {
+            return c.material == volume->GetMaterial() && c.active == active; } );
+        if ( component == components.end() ) components.push_back( {volume->GetMaterial(), active, ownVolume} );
+        else component->volume += ownVolume;
+    };
+
+    //Each period is a slab along its thinnest dimension
+    //
+    for ( auto volume : *G4LogicalVolumeStore::GetInstance() ) {
+        if ( !volumeRoles->HasAnyRole( volume, VolumeRole::Period ) ) continue;
+        G4ThreeVector pMin, pMax;
+        volume->GetSolid()->BoundingLimits( pMin, pMax );
+        const auto extent = pMax - pMin;
+        const G4double volumeOfPeriod = volume->GetSolid()->GetCubicVolume();
+        periodVolume += volumeOfPeriod;
+        periodThickness += volumeOfPeriod * std::min( { extent.x(), extent.y(), extent.z() } );
+        addVolume( volume, false );
+    }
+
+    G4double activeVolume = 0.;
+    for ( const auto& component : components ) { if ( component.active ) activeVolume += component.volume; }
+    if ( components.empty() || periodVolume <= 0. || activeVolume <= 0. ) {
+        G4ExceptionDescription msg;
+        msg << "No Tile period with scintillators found in the geometry, "
+            << "the EM shower fast simulation is disabled." << G4endl;
+        G4Exception("ATLTileCalTBEMShowerParameters::Update()",
+        "MyCode0020", JustWarning, msg);
+        return;
+    }
+    periodThickness /= periodVolume;
+
+    //Effective medium (GFlash sampling calorimeter)
+    //
+    constexpr G4double scaleEnergy = 21.2052*MeV;
+    G4double totalVolume = 0., totalMass = 0.;
+    G4double inverseRadiationLength = 0., lossPerLength = 0.;
+    G4double massZ = 0., activeMass = 0., activeMassZ = 0.;
+    for ( const auto& component : components ) {
+        const auto material = component.material;
+        G4double Z = 0.;
+        for ( std::size_t i = 0; i < material->GetNumberOfElements(); ++i ) {
+            Z += material->GetFractionVector()[i] * material->GetElement(i)->GetZ();
+        }
+        const G4double mass = component.volume * material->GetDensity();
+        const G4double criticalEnergy = 610.*MeV / ( Z + 1.24 );
+        totalVolume += component.volume;
+        totalMass += mass;
+        inverseRadiationLength += component.volume / material->GetRadlen();
+        lossPerLength += component.volume * criticalEnergy / material->GetRadlen();
+        massZ += mass * Z;
+        if ( component.active ) {
+            activeMass += mass;
+            activeMassZ += mass * Z;
+        }
+    }
+    inverseRadiationLength /= totalVolume;
+    lossPerLength /= totalVolume;
+
+    fRadiationLength = 1. / inverseRadiationLength;
+    fCriticalEnergy = fRadiationLength * lossPerLength;
+    fMoliereRadius = scaleEnergy / lossPerLength;
+    fEffectiveZ = massZ / totalMass;
+    fSamplingFrequency = fRadiationLength / periodThickness;
+    const G4double activeZ = activeMassZ / activeMass;
+    const G4double passiveZ = ( totalMass > activeMass ) ? ( massZ - activeMassZ ) / ( totalMass - activeMass ) : activeZ;
+    fEHat = 1. / ( 1. + 0.007 * ( passiveZ - activeZ ) );
+    const G4double samplingFraction = ATLTileCalTBConstants::sampling_fraction / ATLTileCalTBConstants::pe_conversion_correction;
+    fScintillatorWeight = samplingFraction / ( activeVolume / totalVolume );
+    fValid = true;
+
+}
+
+//Print() method
+//
+void ATLTileCalTBEMShowerParameters::Print() const {
+    if ( !IsEnabled() ) {
+        G4cout << "EM shower fast simulation disabled" << G4endl;
+        return;
+    }
+    G4cout << "EM shower fast simulation above " << G4BestUnit(fMinEnergy, "Energy")
+           << " with X0 " << G4BestUnit(fRadiationLength, "Length")
+           << ", RM " << G4BestUnit(fMoliereRadius, "Length")
+           << ", Ec " << G4BestUnit(fCriticalEnergy, "Energy")
+           << ", Z " << fEffectiveZ
+           << ", Fs " << fSamplingFrequency
+           << ", e/mip " << fEHat
+           << ", spots of " << G4BestUnit(fSpotEnergy, "Energy")
+           << ", scintillator weight " << fScintillatorWeight
+           << " x response scale " << fResponseScale
+           << ( fFluctuations ? "" : ", average profiles" ) << G4endl;
+}
+
+#endif //ATLTileCalTB_FastSim
+
+//**************************************************
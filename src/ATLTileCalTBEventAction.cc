@@ -12,7 +12,6 @@
 #include "ATLTileCalTBEventAction.hh"
 #include "ATLTileCalTBGeometry.hh"
 #include "ATLTileCalTBConstants.hh"
-#include "ATLTileCalTBPrimaryGenAction.hh"
 #ifdef ATLTileCalTB_LEAKANALYSIS
 #include "SpectrumAnalyzer.hh"
 #endif
@@ -21,8 +20,8 @@
 //
 #include "G4Event.hh"
 #include "Randomize.hh"
-#include "G4ParticleGun.hh"
 #include "G4Version.hh"
+#include "G4AccumulableManager.hh"
 #if G4VERSION_NUMBER < 1100
 #include "g4root.hh"  // replaced by G4AnalysisManager.h  in G4 v11 and up
 #else
@@ -32,11 +31,15 @@
 #include "G4RunManager.hh"
 #include "G4Run.hh"
 #endif
+#ifdef ATLTileCalTB_SubEvent
+#include "G4EventManager.hh"
+#endif
 
 //Includers from C++
 //
 #include <numeric>
 #include <algorithm>
+#include <cstdint>
 #ifdef ATLTileCalTB_PulseOutput
 #include <fstream>
 #include <sstream>
@@ -45,24 +48,78 @@
 
 //Constructor and de-constructor
 //
-ATLTileCalTBEventAction::ATLTileCalTBEventAction(ATLTileCalTBPrimaryGenAction* pga)
+ATLTileCalTBEventAction::ATLTileCalTBEventAction()
     : G4UserEventAction(),
-      fPrimaryGenAction(pga),
       fNoOfCells(ATLTileCalTBGeometry::CellLUT::GetInstance()->GetNumberOfCells()),
-      fAux{0., 0.} {
+      fAux{0., 0.},
+      fReconstruction(Reconstruction::Peak),
+      fBatchedDigi(false),
+      fDigiBatchEvents(1),
+      fPhaseWritten(false),
+      fSimulatedEvents("SimulatedEvents", 0) {
     fEdepVector = std::vector<G4double>(fNoOfCells, 0.);
     fSdepVector = std::vector<G4double>(fNoOfCells, 0.);
+    fPhaseVector = std::vector<G4double>(fNoOfCells, 0.);
+
+    //Reset and merged by the run action with the other accumulables
+    //
+    G4AccumulableManager::Instance()->RegisterAccumulable(fSimulatedEvents);
+
+    //Digitization commands
+    //
+    fMessenger = new G4GenericMessenger(this, "/ATLTileCalTB/digi/", "Digitization control");
+    fMessenger->DeclareMethod("reconstruction", &ATLTileCalTBEventAction::SetReconstruction,
+        "Signal reconstruction: pulse peak over all frames (peak) or optimal filtering of 7 samples at 25 ns (optimalFiltering)")
+        .SetParameterName("mode", false)
+        .SetCandidates("peak optimalFiltering");
+    #if !defined(ATLTileCalTB_SparseHits) && !defined(ATLTileCalTB_PulseOutput)
+    fMessenger->DeclareMethod("batched", &ATLTileCalTBEventAction::SetBatchedDigi,
+        "Digitize all the cells of one or more events with a single Toeplitz matrix product (not with optimalFiltering)")
+        .SetParameterName("batched", true)
+        .SetDefaultValue("true");
+    fMessenger->DeclareProperty("batchEvents", fDigiBatchEvents,
+        "Number of events per thread digitized together in batched mode")
+        .SetParameterName("events", false)
+        .SetRange("events>=1");
+    #endif
 }
 
 ATLTileCalTBEventAction::~ATLTileCalTBEventAction() {
+    delete fMessenger;
+}
+
+//SetReconstruction() and SetBatchedDigi() methods
+//Optimal filtering samples each pulse on its own, batched digitization
+//is switched off by optimalFiltering and refused after it
+//
+void ATLTileCalTBEventAction::SetReconstruction( const G4String& mode ) {
+    fReconstruction = ( mode == "optimalFiltering" ) ? Reconstruction::OptimalFiltering : Reconstruction::Peak;
+    if ( fReconstruction == Reconstruction::OptimalFiltering && fBatchedDigi ) {
+        G4Exception("ATLTileCalTBEventAction::SetReconstruction()",
+        "MyCode0016", JustWarning, "Batched digitization disabled by the optimal filtering reconstruction.");
+        fBatchedDigi = false;
+    }
+}
+
+void ATLTileCalTBEventAction::SetBatchedDigi( G4bool batched ) {
+    if ( batched && fReconstruction == Reconstruction::OptimalFiltering ) {
+        G4Exception("ATLTileCalTBEventAction::SetBatchedDigi()",
+        "MyCode0016", JustWarning, "Batched digitization not available with the optimal filtering reconstruction, command ignored.");
+        return;
+    }
+    fBatchedDigi = batched;
 }
 
 //BeginOfEvent() method
 //
 void ATLTileCalTBEventAction::BeginOfEventAction([[maybe_unused]] const G4Event* event) {
+    //Edep and Sdep are written for every cell at the end of the event,
+    //Phase only in optimal filtering mode
     for ( auto& value : fAux ){ value = 0.; } 
-    for ( auto& value : fEdepVector ) { value = 0.; }
-    for ( auto& value : fSdepVector ) { value = 0.; }
+    if ( fPhaseWritten && fReconstruction != Reconstruction::OptimalFiltering ) {
+        std::fill(fPhaseVector.begin(), fPhaseVector.end(), 0.);
+        fPhaseWritten = false;
+    }
 
     #ifdef ATLTileCalTB_PulseOutput
     auto runNumber = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
@@ -93,122 +150,314 @@ ATLTileCalTBHitsCollection* ATLTileCalTBEventAction::GetHitsCollection(G4int hcI
 
 }    
 
-//EndOfEventaction() method
+#ifdef ATLTileCalTB_SubEvent
+//GetCurrentEventInformation() method
+//Sub-events get an information without event ID
 //
-void ATLTileCalTBEventAction::EndOfEventAction( const G4Event* event ) {
+ATLTileCalTBEventInformation* ATLTileCalTBEventAction::GetCurrentEventInformation() {
+    auto event = G4EventManager::GetEventManager()->GetNonconstCurrentEvent();
+    auto information = static_cast<ATLTileCalTBEventInformation*>( event->GetUserInformation() );
+    if ( ! information ) {
+        information = new ATLTileCalTBEventInformation( -1, 0, 0. );
+        event->SetUserInformation( information );
+    }
+    return information;
+}
+
+//MergeSubEvent() method
+//Called by Geant4 once a sub-event is over, before the end of
+//the event that spawned it
+//
+void ATLTileCalTBEventAction::MergeSubEvent( G4Event* masterEvent, const G4Event* subEvent ) {
+
+    auto masterInformation = static_cast<ATLTileCalTBEventInformation*>( masterEvent->GetUserInformation() );
+    auto subInformation = static_cast<const ATLTileCalTBEventInformation*>( subEvent->GetUserInformation() );
+    if ( masterInformation && subInformation && masterInformation != subInformation ) {
+        masterInformation->Merge( *subInformation );
+    }
+
+    auto masterHCE = masterEvent->GetHCofThisEvent();
+    auto subHCE = subEvent->GetHCofThisEvent();
+    auto masterHC = masterHCE ? static_cast<ATLTileCalTBHitsCollection*>( masterHCE->GetHC(0) ) : nullptr;
+    auto subHC = subHCE ? static_cast<ATLTileCalTBHitsCollection*>( subHCE->GetHC(0) ) : nullptr;
+    if ( ! masterHC || ! subHC || masterHC->entries() < fNoOfCells || subHC->entries() < fNoOfCells ) {
+        G4ExceptionDescription msg;
+        msg << "Cannot merge the hits of a sub-event of event " << masterEvent->GetEventID()
+            << ": missing or incomplete hitsCollection";
+        G4Exception("ATLTileCalTBEventAction::MergeSubEvent()",
+        "MyCode0018", FatalException, msg);
+        return;
+    }
+    for (std::size_t n = 0; n < fNoOfCells; ++n) {
+        auto masterHit = (*masterHC)[n];
+        auto subHit = (*subHC)[n];
+        if ( masterHit && subHit ) masterHit->Merge( *subHit );
+    }
+
+}
+#endif
+
+//FillNtuple() method
+//Edep and Sdep are taken from fEdepVector and fSdepVector
+//
+void ATLTileCalTBEventAction::FillNtuple( const std::array<G4double, nAuxData>& aux, G4int pdgID, G4double eBeam, G4int eventID ) {
 
     auto analysisManager = G4AnalysisManager::Instance();
 
     G4int counter = 0;
-    for ( auto& value : fAux ){ 
+    for ( auto& value : aux ){ 
         analysisManager->FillNtupleDColumn( counter, value );    
         counter++;
     }
 
-    //Method to convolute signal for PMT response
-    //From https://gitlab.cern.ch/allpix-squared/allpix-squared/-/blob/86fe21ad37d353e36a509a0827562ab7fadd5104/src/modules/CSADigitizer/CSADigitizerModule.cpp#L271-L283
-    auto ConvolutePMT = [](const std::array<G4double, ATLTileCalTBConstants::frames>& sdep) {
-        constexpr auto pmt_response_size = ATLTileCalTBConstants::pmt_response.size();
-        auto outvec = std::array<G4double, ATLTileCalTBConstants::frames>();
-        for (std::size_t k = 0; k < outvec.size(); ++k) {
-            G4double outsum = 0.;
-            auto jmax = (k >= pmt_response_size) ? pmt_response_size - 1 : k;
-            for (std::size_t j = 0; j <= jmax; ++j) {
-                outsum += sdep[k - j] * ATLTileCalTBConstants::pmt_response[j];
+    //Add sums to Ntuple
+    analysisManager->FillNtupleDColumn(2, std::accumulate(fEdepVector.begin(), fEdepVector.end(), 0));
+    analysisManager->FillNtupleDColumn(3, std::accumulate(fSdepVector.begin(), fSdepVector.end(), 0));
+
+    analysisManager->FillNtupleIColumn(6, pdgID);
+    analysisManager->FillNtupleFColumn(7, eBeam);
+    analysisManager->FillNtupleIColumn(9, eventID);
+
+    analysisManager->AddNtupleRow();
+
+}
+
+//ApplyNoise() method
+//Add electronic noise and keep the signal if larger than 2 * noise
+//
+G4double ATLTileCalTBEventAction::ApplyNoise( G4double sdep_up, G4double sdep_down,
+                                             [[maybe_unused]] G4double noise_up, [[maybe_unused]] G4double noise_down ) {
+    #ifdef ATLTileCalTB_NoNoise
+    return sdep_up + sdep_down;
+    #else
+    sdep_up += noise_up;
+    sdep_down += noise_down;
+    auto sdep_sum = sdep_up + sdep_down;
+    return (sdep_sum > 2 * ATLTileCalTBConstants::signal_noise_sigma) ? sdep_sum : 0.;
+    #endif
+}
+
+//GetDigitizer() method
+//The event action can be built before the binning commands,
+//the digitizer is created when first needed
+//
+ATLTileCalTBVDigitizer& ATLTileCalTBEventAction::GetDigitizer() {
+    if ( !fDigitizer ) fDigitizer = ATLTileCalTBVDigitizer::Create();
+    return *fDigitizer;
+}
+
+//BufferEvent() method
+//Store the event and stack its active channels for the batched digitization
+//
+void ATLTileCalTBEventAction::BufferEvent( const ATLTileCalTBHitsCollection* HC, const ATLTileCalTBEventInformation& information ) {
+
+    BufferedEvent buffered;
+    buffered.aux = fAux;
+    buffered.edep.resize(fNoOfCells);
+    buffered.channel.resize(fNoOfCells);
+    buffered.pdgID = information.GetPDGID();
+    buffered.eBeam = information.GetEBeam();
+    buffered.eventID = information.GetEventID();
+
+    for (std::size_t n = 0; n < fNoOfCells; ++n) {
+        auto hit = (*HC)[n];
+        buffered.edep[n] = hit->GetEdep();
+        buffered.channel[n] = SIZE_MAX;
+        #if !defined(ATLTileCalTB_SparseHits)
+        if ( hit->IsActive() ) {
+            buffered.channel[n] = GetDigitizer().AddToBatch(*hit);
+        }
+        #endif
+        #ifndef ATLTileCalTB_NoNoise
+        buffered.noise.push_back(G4RandGauss::shoot(0., ATLTileCalTBConstants::signal_noise_sigma));
+        buffered.noise.push_back(G4RandGauss::shoot(0., ATLTileCalTBConstants::signal_noise_sigma));
+        #else
+        buffered.noise.insert(buffered.noise.end(), 2, 0.);
+        #endif
+    }
+
+    fBufferedEvents.push_back(std::move(buffered));
+
+}
+
+//FlushDigitization() method
+//
+void ATLTileCalTBEventAction::FlushDigitization() {
+
+    if ( fBufferedEvents.empty() ) return;
+
+    auto& digitizer = GetDigitizer();
+    digitizer.ConvoluteBatch();
+    for ( const auto& buffered : fBufferedEvents ) {
+        for (std::size_t n = 0; n < fNoOfCells; ++n) {
+            auto channel = buffered.channel[n];
+            G4double sdep_up = (channel == SIZE_MAX) ? 0. : digitizer.GetBatchMax(channel);
+            G4double sdep_down = (channel == SIZE_MAX) ? 0. : digitizer.GetBatchMax(channel + 1);
+            fEdepVector[n] = buffered.edep[n];
+            fSdepVector[n] = ApplyNoise(sdep_up, sdep_down, buffered.noise[2 * n], buffered.noise[2 * n + 1]);
+        }
+        FillNtuple(buffered.aux, buffered.pdgID, buffered.eBeam, buffered.eventID);
+    }
+
+    digitizer.ClearBatch();
+    fBufferedEvents.clear();
+
+}
+
+//EndOfEventaction() method
+//
+void ATLTileCalTBEventAction::EndOfEventAction( const G4Event* event ) {
+
+    //End of the transport of the event, used by the scaling report
+    //of the run action
+    fLastEventEnd = std::chrono::steady_clock::now();
+
+    //Events left empty by the other shards or ranks and sub-events
+    //are not written
+    //
+    auto information = static_cast<ATLTileCalTBEventInformation*>( event->GetUserInformation() );
+    if ( !information || information->GetEventID() < 0 ) return;
+    #ifdef ATLTileCalTB_SubEvent
+    //An event is written once all its sub-events are merged, by the
+    //worker that tracked it or by the master thread
+    if ( event->GetSubEventType() >= 0 || event->GetNumberOfRemainingSubEvents() > 0 || information->IsWritten() ) return;
+    information->SetWritten();
+    //Deposits of the event and of its merged sub-events
+    fAux = information->GetAux();
+    #endif
+    fSimulatedEvents += 1;
+
+    auto HC = GetHitsCollection(0, event);
+
+    //Optimal filtering mode: amplitude and phase from 7 samples per PMT
+    //
+    if ( fReconstruction == Reconstruction::OptimalFiltering ) {
+        auto& digitizer = GetDigitizer();
+        ATLTileCalTBVDigitizer::Samples samples_up, samples_down;
+        for (std::size_t n = 0; n < fNoOfCells; ++n) {
+            auto hit = (*HC)[n];
+            G4double sdep_up = 0.;
+            G4double sdep_down = 0.;
+            fPhaseVector[n] = 0.;
+            fPhaseWritten = true;
+            if ( hit->IsActive() ) {
+                digitizer.Sample(*hit, samples_up, samples_down);
+                sdep_up = digitizer.GetOFAmplitude(samples_up);
+                sdep_down = digitizer.GetOFAmplitude(samples_down);
+                //Phase of the cell from the sum of the two PMTs
+                for (std::size_t i = 0; i < samples_up.size(); ++i) { samples_up[i] += samples_down[i]; }
+                fPhaseVector[n] = digitizer.GetOFPhase(samples_up, sdep_up + sdep_down);
             }
-            outvec[k] = outsum;
+            G4double noise_up = 0.;
+            G4double noise_down = 0.;
+            #ifndef ATLTileCalTB_NoNoise
+            noise_up = G4RandGauss::shoot(0., ATLTileCalTBConstants::signal_noise_sigma);
+            noise_down = G4RandGauss::shoot(0., ATLTileCalTBConstants::signal_noise_sigma);
+            #endif
+            fEdepVector[n] = hit->GetEdep();
+            fSdepVector[n] = ApplyNoise(sdep_up, sdep_down, noise_up, noise_down);
+            if ( fSdepVector[n] == 0. ) fPhaseVector[n] = 0.;
         }
-        return outvec;
-    };
+        FillNtuple(fAux, information->GetPDGID(), information->GetEBeam(), information->GetEventID());
+        #ifdef ATLTileCalTB_LEAKANALYSIS
+        SpectrumAnalyzer::GetInstance()->FillEventFields(information->GetEventID());
+        #endif
+        return;
+    }
+
+    //Batched mode: digitization and ntuple filling every fDigiBatchEvents events
+    //
+    if ( fBatchedDigi ) {
+        BufferEvent(HC, *information);
+        if ( fBufferedEvents.size() >= static_cast<std::size_t>(fDigiBatchEvents) ) FlushDigitization();
+        #ifdef ATLTileCalTB_LEAKANALYSIS
+        SpectrumAnalyzer::GetInstance()->FillEventFields(information->GetEventID());
+        #endif
+        return;
+    }
 
     //Method to get sdep from hit
-    auto GetSdep = [ConvolutePMT, this]
+    auto GetSdep = [this]
     (const ATLTileCalTBHitsCollection* HC, std::size_t cell_index) -> G4double {
         auto hit = (*HC)[cell_index];
 
-        //PMT response
-        auto sdep_up_v = ConvolutePMT(hit->GetSdepUp());
-        auto sdep_down_v = ConvolutePMT(hit->GetSdepDown());
-
-        //Create output pulses if requested
-        #ifdef ATLTileCalTB_PulseOutput
-        {
-            // Add signals
-            std::array<G4double, ATLTileCalTBConstants::frames> sdep_sum_v;
-            for (std::size_t n = 0; n < sdep_sum_v.size(); ++n) {
-                sdep_sum_v[n] = sdep_up_v[n] + sdep_down_v[n];
-            }
+        //Cells without photoelectrons skip the PMT response and only get noise
+        G4double sdep_up = 0.;
+        G4double sdep_down = 0.;
 
-            // Check that vector is not empty
-            if (std::accumulate(sdep_sum_v.begin(), sdep_sum_v.end(), 0) != 0.) {
-                // Generate file name
-                auto cell = ATLTileCalTBGeometry::CellLUT::GetInstance()->GetCell(cell_index);
-                std::ostringstream fileName;
-                fileName << pulse_event_path.string() << "/Mod";
-                switch (cell.module) {
-                    case ATLTileCalTBGeometry::Module::LONG_LOWER:
-                        fileName << "LL";
-                        break;
-                    case ATLTileCalTBGeometry::Module::LONG_UPPER:
-                        fileName << "LU";
-                        break;
-                    case ATLTileCalTBGeometry::Module::EXTENDED:
-                    case ATLTileCalTBGeometry::Module::EXTENDED_C10:
-                    case ATLTileCalTBGeometry::Module::EXTENDED_D4:
-                        fileName << "EX";
-                        break;
+        if ( hit->IsActive() ) {
+            #ifdef ATLTileCalTB_PulseOutput
+            //PMT response and maximum (pulses are zero before the first frame)
+            std::vector<G4double> sdep_up_v, sdep_down_v;
+            GetDigitizer().DigitizePulses(*hit, sdep_up_v, sdep_down_v, sdep_up, sdep_down);
+
+            //Create output pulses
+            {
+                // Add signals
+                std::vector<G4double> sdep_sum_v(sdep_up_v.size());
+                for (std::size_t n = 0; n < sdep_sum_v.size(); ++n) {
+                    sdep_sum_v[n] = sdep_up_v[n] + sdep_down_v[n];
                 }
-                fileName << "_Cell" << cell.row << cell.nCell << ".dat";
 
-                // Open file and add cell label
-                std::ofstream ofs;
-                ofs.open(fileName.str());
-                ofs << "# " << cell << "\n";
+                // Check that vector is not empty
+                if (std::accumulate(sdep_sum_v.begin(), sdep_sum_v.end(), 0) != 0.) {
+                    // Generate file name
+                    auto cell = ATLTileCalTBGeometry::CellLUT::GetInstance()->GetCell(cell_index);
+                    std::ostringstream fileName;
+                    fileName << pulse_event_path.string() << "/Mod";
+                    switch (cell.module) {
+                        case ATLTileCalTBGeometry::Module::LONG_LOWER:
+                            fileName << "LL";
+                            break;
+                        case ATLTileCalTBGeometry::Module::LONG_UPPER:
+                            fileName << "LU";
+                            break;
+                        case ATLTileCalTBGeometry::Module::EXTENDED:
+                        case ATLTileCalTBGeometry::Module::EXTENDED_C10:
+                        case ATLTileCalTBGeometry::Module::EXTENDED_D4:
+                            fileName << "EX";
+                            break;
+                    }
+                    fileName << "_Cell" << cell.row << cell.nCell << ".dat";
 
-                // Fill with values and close
-                for (auto val : sdep_sum_v) {
-                    ofs << val << "\n";
-                }
-                ofs.close();
-            }
-        };
-        #endif
+                    // Open file and add cell label
+                    std::ofstream ofs;
+                    ofs.open(fileName.str());
+                    ofs << "# " << cell << "\n";
 
-        //Use maximum as signal
-        G4double sdep_up = *(std::max_element(sdep_up_v.begin(), sdep_up_v.end()));
-        G4double sdep_down = *(std::max_element(sdep_down_v.begin(), sdep_down_v.end()));
+                    // Fill with values and close
+                    for (auto val : sdep_sum_v) {
+                        ofs << val << "\n";
+                    }
+                    ofs.close();
+                }
+            };
+            #else
+            //PMT response and maximum
+            GetDigitizer().DigitizeMax(*hit, sdep_up, sdep_down);
+            #endif
+        }
 
-        #ifdef ATLTileCalTB_NoNoise
-        return sdep_up + sdep_down;
-        #else
         //Apply electronic noise
-        sdep_up += G4RandGauss::shoot(0., ATLTileCalTBConstants::signal_noise_sigma);
-        sdep_down += G4RandGauss::shoot(0., ATLTileCalTBConstants::signal_noise_sigma);
-
-        //Return sum if signal is larger than 2 * noise
-        auto sdep_sum = sdep_up + sdep_down;
-        return (sdep_sum > 2 * ATLTileCalTBConstants::signal_noise_sigma) ? sdep_sum : 0.;
+        G4double noise_up = 0.;
+        G4double noise_down = 0.;
+        #ifndef ATLTileCalTB_NoNoise
+        noise_up = G4RandGauss::shoot(0., ATLTileCalTBConstants::signal_noise_sigma);
+        noise_down = G4RandGauss::shoot(0., ATLTileCalTBConstants::signal_noise_sigma);
         #endif
+        return ApplyNoise(sdep_up, sdep_down, noise_up, noise_down);
     };
 
     //Get hits collections and fill vector
-    auto HC = GetHitsCollection(0, event);
     for (std::size_t n = 0; n < fNoOfCells; ++n) {
         fEdepVector[n] = (*HC)[n]->GetEdep();
         fSdepVector[n] = GetSdep(HC, n);
     }
 
-    //Add sums to Ntuple
-    analysisManager->FillNtupleDColumn(2, std::accumulate(fEdepVector.begin(), fEdepVector.end(), 0));
-    analysisManager->FillNtupleDColumn(3, std::accumulate(fSdepVector.begin(), fSdepVector.end(), 0));
-
-    analysisManager->FillNtupleIColumn(6, fPrimaryGenAction->GetParticlenGun()->GetParticleDefinition()->GetPDGEncoding());
-    analysisManager->FillNtupleFColumn(7, fPrimaryGenAction->GetParticlenGun()->GetParticleEnergy());
-
-    analysisManager->AddNtupleRow();
+    FillNtuple(fAux, information->GetPDGID(), information->GetEBeam(), information->GetEventID());
     
     #ifdef ATLTileCalTB_LEAKANALYSIS
-    SpectrumAnalyzer::GetInstance()->FillEventFields();
+    SpectrumAnalyzer::GetInstance()->FillEventFields(information->GetEventID());
     #endif
 } 
 
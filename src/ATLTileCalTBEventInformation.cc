@@ -0,0 +1,50 @@
+//**************************************************
+// \file ATLTileCalTBEventInformation.cc
+// \brief: implementation of ATLTileCalTBEventInformation
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+//Includers from project files
+//
+#include "ATLTileCalTBEventInformation.hh"
+
+//Includers from Geant4
+//
+#include "G4ios.hh"
+
+//Constructor
+//
+#ifdef ATLTileCalTB_SubEvent
+ATLTileCalTBEventInformation::ATLTileCalTBEventInformation( G4int eventID, G4int pdgID, G4double eBeam )
+    : G4VUserEventInformation(),
+      fEventID(eventID),
+      fPDGID(pdgID),
+      fEBeam(eBeam),
+      fAux{0., 0.},
+      fWritten(false) {}
+#else
+ATLTileCalTBEventInformation::ATLTileCalTBEventInformation( G4int eventID, G4int pdgID, G4double eBeam )
+    : G4VUserEventInformation(),
+      fEventID(eventID),
+      fPDGID(pdgID),
+      fEBeam(eBeam) {}
+#endif
+
+//Print() method
+//
+void ATLTileCalTBEventInformation::Print() const {
+    G4cout << "ATLTileCalTB event " << fEventID << ", primary " << fPDGID << " of " << fEBeam << " MeV" << G4endl;
+}
+
+#ifdef ATLTileCalTB_SubEvent
+//Merge() method
+//
+void ATLTileCalTBEventInformation::Merge( const ATLTileCalTBEventInformation& subEvent ) {
+    for ( std::size_t i = 0; i < nAuxData; ++i ) { fAux[i] += subEvent.fAux[i]; }
+}
+#endif
+
+//**************************************************
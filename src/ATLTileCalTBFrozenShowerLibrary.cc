@@ -0,0 +1,346 @@
+//**************************************************
+// \file ATLTileCalTBFrozenShowerLibrary.cc
+// \brief: implementation of ATLTileCalTBFrozenShowerLibrary
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+#ifdef ATLTileCalTB_FastSim
+
+//Includers from project files
+//
+#include "ATLTileCalTBFrozenShowerLibrary.hh"
+
+//Includers from Geant4
+//
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "Randomize.hh"
+
+//Includers from C++
+//
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+
+//Includers from POSIX
+//
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr char libraryMagic[8] = {'A', 'T', 'L', 'T', 'F', 'S', 'L', '2'};
+
+    //a * b + c, false if it overflows
+    G4bool MulAdd( std::uint64_t a, std::uint64_t b, std::uint64_t c, std::uint64_t& result ) {
+        constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+        if ( a != 0 && b > max / a ) return false;
+        if ( c > max - a * b ) return false;
+        result = a * b + c;
+        return true;
+    }
+
+    //[first, first + count) within [0, size)
+    G4bool InRange( std::uint64_t first, std::uint64_t count, std::uint64_t size ) {
+        return first <= size && count <= size - first;
+    }
+}
+
+//The records are read in place from the mapped file
+//
+static_assert(std::is_trivially_copyable_v<ATLTileCalTBFrozenShowerLibrary::Header>
+              && std::is_trivially_copyable_v<ATLTileCalTBFrozenShowerLibrary::Slot>
+              && std::is_trivially_copyable_v<ATLTileCalTBFrozenShowerLibrary::Shower>
+              && std::is_trivially_copyable_v<ATLTileCalTBFrozenShowerLibrary::Spot>);
+static_assert(sizeof(ATLTileCalTBFrozenShowerLibrary::Header) == 56
+              && sizeof(ATLTileCalTBFrozenShowerLibrary::Slot) == 16
+              && sizeof(ATLTileCalTBFrozenShowerLibrary::Shower) == 24
+              && sizeof(ATLTileCalTBFrozenShowerLibrary::Spot) == 16,
+              "frozen shower records must keep their on-disk size");
+
+//GetInstance() method
+//One instance per process, configured by the master thread
+//
+ATLTileCalTBFrozenShowerLibrary* ATLTileCalTBFrozenShowerLibrary::GetInstance() {
+    static ATLTileCalTBFrozenShowerLibrary instance;
+    return &instance;
+}
+
+//Constructor and de-constructor
+//
+ATLTileCalTBFrozenShowerLibrary::ATLTileCalTBFrozenShowerLibrary()
+    : fData(nullptr),
+      fDataSize(0),
+      fHeader(nullptr),
+      fSlots(nullptr),
+      fShowers(nullptr),
+      fSpots(nullptr),
+      fMinEnergy(10.*MeV),
+      fMaxEnergy(300.*MeV),
+      fNoOfEnergyBins(10),
+      fNoOfAngleBins(4),
+      fMaxShowersPerSlot(200) {
+
+    //Commands are not broadcasted, as the library is shared by all
+    //threads, the binning of the generation is fixed at PreInit
+    //
+    fMessenger = new G4GenericMessenger(this, "/ATLTileCalTB/frozen/", "Frozen shower library in the Tile periods");
+    fMessenger->DeclareMethod("library", &ATLTileCalTBFrozenShowerLibrary::Load,
+        "Memory-map a frozen shower library to replace the low-energy e+, e- and gamma")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclareMethod("generate", &ATLTileCalTBFrozenShowerLibrary::SetOutputFileName,
+        "Record the showers of the primary particle and write them to this file at the end of each run")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclarePropertyWithUnit("minEnergy", "MeV", fMinEnergy,
+        "Lower edge of the energy bins of the generated library")
+        .SetStates(G4State_PreInit)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclarePropertyWithUnit("maxEnergy", "MeV", fMaxEnergy,
+        "Upper edge of the energy bins of the generated library")
+        .SetStates(G4State_PreInit)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclareProperty("energyBins", fNoOfEnergyBins,
+        "Number of logarithmic energy bins of the generated library")
+        .SetStates(G4State_PreInit)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclareProperty("angleBins", fNoOfAngleBins,
+        "Number of bins in cos(theta) to the period axis of the generated library")
+        .SetStates(G4State_PreInit)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclareProperty("showersPerSlot", fMaxShowersPerSlot,
+        "Maximum number of generated showers per energy bin, angle bin and row")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+
+}
+
+ATLTileCalTBFrozenShowerLibrary::~ATLTileCalTBFrozenShowerLibrary() {
+    Unload();
+    delete fMessenger;
+}
+
+//Load() method
+//The file is validated once, lookups index the mapped records directly
+//
+void ATLTileCalTBFrozenShowerLibrary::Load( const G4String& fileName ) {
+
+    Unload();
+
+    auto throwLibraryError = [&fileName](const G4String& reason) {
+        G4ExceptionDescription msg;
+        msg << "Cannot use frozen shower library " << fileName << ": " << reason << G4endl;
+        G4Exception("ATLTileCalTBFrozenShowerLibrary::Load()",
+        "MyCode0011", FatalException, msg);
+    };
+
+    const int fd = open( fileName.c_str(), O_RDONLY );
+    if ( fd < 0 ) return throwLibraryError("cannot open file");
+    struct stat fileStat;
+    if ( fstat( fd, &fileStat ) != 0 || static_cast<std::size_t>(fileStat.st_size) < sizeof(Header) ) {
+        close( fd );
+        return throwLibraryError("file too short");
+    }
+    const auto size = static_cast<std::size_t>(fileStat.st_size);
+    void* data = mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( data == MAP_FAILED ) return throwLibraryError("mmap failed");
+
+    auto rejectLibrary = [&](const G4String& reason) {
+        munmap( data, size );
+        throwLibraryError(reason);
+    };
+
+    //Header, then the sizes of the sections without overflow
+    //
+    const auto header = static_cast<const Header*>(data);
+    if ( std::memcmp( header->magic, libraryMagic, sizeof(libraryMagic) ) != 0 ) return rejectLibrary("invalid format");
+    if ( header->byteOrder != fByteOrder ) return rejectLibrary("written on a machine with another byte order");
+    if ( header->noOfRows != fNoOfRows || header->noOfEnergyBins == 0 || header->noOfAngleBins == 0
+         || !(header->minEnergy > 0.) || !(header->maxEnergy > header->minEnergy) ) {
+        return rejectLibrary("invalid binning");
+    }
+    std::uint64_t noOfSlots = 0, expectedSize = sizeof(Header);
+    if ( !MulAdd( header->noOfEnergyBins, header->noOfAngleBins, 0, noOfSlots )
+         || !MulAdd( noOfSlots, header->noOfRows, 0, noOfSlots )
+         || !MulAdd( noOfSlots, sizeof(Slot), expectedSize, expectedSize )
+         || !MulAdd( header->noOfShowers, sizeof(Shower), expectedSize, expectedSize )
+         || !MulAdd( header->noOfSpots, sizeof(Spot), expectedSize, expectedSize )
+         || size != expectedSize ) {
+        return rejectLibrary("file size does not match the header");
+    }
+
+    //Every slot and shower within its section
+    //
+    const auto slots = reinterpret_cast<const Slot*>(header + 1);
+    const auto showers = reinterpret_cast<const Shower*>(slots + noOfSlots);
+    for ( std::uint64_t i = 0; i < noOfSlots; ++i ) {
+        if ( !InRange( slots[i].firstShower, slots[i].noOfShowers, header->noOfShowers ) ) {
+            return rejectLibrary("slot " + std::to_string(i) + " outside of the showers");
+        }
+    }
+    for ( std::uint64_t i = 0; i < header->noOfShowers; ++i ) {
+        if ( !InRange( showers[i].firstSpot, showers[i].noOfSpots, header->noOfSpots ) ) {
+            return rejectLibrary("shower " + std::to_string(i) + " outside of the spots");
+        }
+    }
+
+    fData = data;
+    fDataSize = size;
+    fFileName = fileName;
+    fHeader = header;
+    fSlots = slots;
+    fShowers = showers;
+    fSpots = reinterpret_cast<const Spot*>(showers + header->noOfShowers);
+
+}
+
+//Unload() method
+//
+void ATLTileCalTBFrozenShowerLibrary::Unload() {
+    if ( fData ) munmap( fData, fDataSize );
+    fData = nullptr;
+    fDataSize = 0;
+    fHeader = nullptr;
+    fSlots = nullptr;
+    fShowers = nullptr;
+    fSpots = nullptr;
+    fFileName = "";
+}
+
+//GetEnergyBin() method
+//
+G4int ATLTileCalTBFrozenShowerLibrary::GetEnergyBin( G4double energy, G4double minEnergy, G4double maxEnergy, G4int noOfEnergyBins ) {
+    if ( energy < minEnergy || energy >= maxEnergy ) return -1;
+    const auto bin = static_cast<G4int>( noOfEnergyBins * std::log( energy/minEnergy )/std::log( maxEnergy/minEnergy ) );
+    return std::min( bin, noOfEnergyBins - 1 );
+}
+
+//GetAngleBin() method
+//
+G4int ATLTileCalTBFrozenShowerLibrary::GetAngleBin( G4double cosTheta, G4int noOfAngleBins ) {
+    const auto bin = static_cast<G4int>( 0.5 * ( cosTheta + 1. ) * noOfAngleBins );
+    return std::min( std::max( bin, 0 ), noOfAngleBins - 1 );
+}
+
+//Lookup() method
+//
+const ATLTileCalTBFrozenShowerLibrary::Shower* ATLTileCalTBFrozenShowerLibrary::Lookup( G4double energy, const Entry& entry ) const {
+    if ( !fHeader || entry.row < 0 || entry.row >= static_cast<G4int>(fNoOfRows) ) return nullptr;
+    const G4int bin = GetEnergyBin( energy, fHeader->minEnergy, fHeader->maxEnergy, fHeader->noOfEnergyBins );
+    if ( bin < 0 ) return nullptr;
+    const G4int angleBin = GetAngleBin( entry.cosTheta, fHeader->noOfAngleBins );
+    const auto& slot = fSlots[( static_cast<std::size_t>(bin) * fHeader->noOfAngleBins + angleBin ) * fNoOfRows + entry.row];
+    if ( slot.noOfShowers == 0 ) return nullptr;
+    const auto shower = std::min( static_cast<std::uint64_t>( G4UniformRand() * slot.noOfShowers ), slot.noOfShowers - 1 );
+    return fShowers + slot.firstShower + shower;
+}
+
+//SetOutputFileName() method
+//Starting a new generation drops the showers of the previous one
+//
+void ATLTileCalTBFrozenShowerLibrary::SetOutputFileName( const G4String& fileName ) {
+    G4AutoLock lock(&fMutex);
+    fOutputFileName = fileName;
+    fGeneratedShowers.clear();
+}
+
+//InGenerationRange() method
+//
+G4bool ATLTileCalTBFrozenShowerLibrary::InGenerationRange( G4double energy ) const {
+    return GetEnergyBin( energy, fMinEnergy, fMaxEnergy, fNoOfEnergyBins ) >= 0;
+}
+
+//AddShower() method
+//
+void ATLTileCalTBFrozenShowerLibrary::AddShower( G4double energy, const Entry& entry, const std::vector<Spot>& spots ) {
+    const G4int bin = GetEnergyBin( energy, fMinEnergy, fMaxEnergy, fNoOfEnergyBins );
+    if ( bin < 0 || entry.row < 0 || entry.row >= static_cast<G4int>(fNoOfRows) ) return;
+    const G4int angleBin = GetAngleBin( entry.cosTheta, fNoOfAngleBins );
+
+    G4AutoLock lock(&fMutex);
+    if ( fGeneratedShowers.empty() ) {
+        fGeneratedShowers.resize( static_cast<std::size_t>(fNoOfEnergyBins) * fNoOfAngleBins * fNoOfRows );
+    }
+    auto& slot = fGeneratedShowers[( static_cast<std::size_t>(bin) * fNoOfAngleBins + angleBin ) * fNoOfRows + entry.row];
+    if ( static_cast<G4int>(slot.size()) >= fMaxShowersPerSlot ) return;
+    slot.push_back( {static_cast<float>(energy), static_cast<float>(entry.phase), static_cast<float>(entry.azimuth), spots} );
+}
+
+//Write() method
+//
+void ATLTileCalTBFrozenShowerLibrary::Write() const {
+
+    G4AutoLock lock(&fMutex);
+
+    const std::size_t noOfSlots = static_cast<std::size_t>(fNoOfEnergyBins) * fNoOfAngleBins * fNoOfRows;
+    Header header;
+    std::memcpy( header.magic, libraryMagic, sizeof(libraryMagic) );
+    header.byteOrder = fByteOrder;
+    header.noOfRows = static_cast<std::uint32_t>(fNoOfRows);
+    header.noOfEnergyBins = static_cast<std::uint32_t>(fNoOfEnergyBins);
+    header.noOfAngleBins = static_cast<std::uint32_t>(fNoOfAngleBins);
+    header.minEnergy = fMinEnergy;
+    header.maxEnergy = fMaxEnergy;
+    header.noOfShowers = 0;
+    header.noOfSpots = 0;
+
+    std::vector<Slot> slots( noOfSlots, Slot{0, 0} );
+    std::vector<Shower> showers;
+    std::vector<Spot> spots;
+    for ( std::size_t i = 0; i < noOfSlots && i < fGeneratedShowers.size(); ++i ) {
+        slots[i] = {showers.size(), fGeneratedShowers[i].size()};
+        for ( const auto& generated : fGeneratedShowers[i] ) {
+            showers.push_back( {spots.size(), static_cast<std::uint32_t>(generated.spots.size()), generated.energy,
+                                generated.phase, generated.azimuth} );
+            spots.insert( spots.end(), generated.spots.begin(), generated.spots.end() );
+        }
+    }
+    header.noOfShowers = showers.size();
+    header.noOfSpots = spots.size();
+
+    std::ofstream file( fOutputFileName, std::ios::binary | std::ios::trunc );
+    file.write( reinterpret_cast<const char*>(&header), sizeof(Header) );
+    file.write( reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(Slot) );
+    file.write( reinterpret_cast<const char*>(showers.data()), showers.size() * sizeof(Shower) );
+    file.write( reinterpret_cast<const char*>(spots.data()), spots.size() * sizeof(Spot) );
+    if ( !file ) {
+        G4ExceptionDescription msg;
+        msg << "Cannot write frozen shower library " << fOutputFileName << G4endl;
+        G4Exception("ATLTileCalTBFrozenShowerLibrary::Write()",
+        "MyCode0012", JustWarning, msg);
+        return;
+    }
+    G4cout << "Frozen shower library " << fOutputFileName << " written with " << header.noOfShowers
+           << " showers and " << header.noOfSpots << " spots" << G4endl;
+
+}
+
+//Print() method
+//
+void ATLTileCalTBFrozenShowerLibrary::Print() const {
+    if ( IsGenerating() ) {
+        G4cout << "Generating frozen shower library " << fOutputFileName << " from "
+               << G4BestUnit(fMinEnergy, "Energy") << " to " << G4BestUnit(fMaxEnergy, "Energy")
+               << " in " << fNoOfEnergyBins << " energy bins and " << fNoOfAngleBins << " angle bins" << G4endl;
+    }
+    if ( IsLoaded() ) {
+        G4cout << "Frozen shower library " << fFileName << " with " << fHeader->noOfShowers << " showers from "
+               << G4BestUnit(fHeader->minEnergy, "Energy") << " to " << G4BestUnit(fHeader->maxEnergy, "Energy")
+               << " in " << fHeader->noOfEnergyBins << " energy bins and " << fHeader->noOfAngleBins << " angle bins" << G4endl;
+    }
+}
+
+#endif //ATLTileCalTB_FastSim
+
+//**************************************************
@@ -0,0 +1,193 @@
+//**************************************************
+// \file ATLTileCalTBFrozenShowerModel.cc
+// \brief: implementation of ATLTileCalTBFrozenShowerModel
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+#ifdef ATLTileCalTB_FastSim
+
+//Includers from project files
+//
+#include "ATLTileCalTBFrozenShowerModel.hh"
+#include "ATLTileCalTBFrozenShowerRecorder.hh"
+#include "ATLTileCalTBGeometry.hh"
+
+//Includers from Geant4
+//
+#include "G4FastHit.hh"
+#include "G4FastSimHitMaker.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4Electron.hh"
+#include "G4Gamma.hh"
+#include "G4Positron.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4TouchableHistory.hh"
+
+//Includers from C++
+//
+#include <algorithm>
+#include <cmath>
+
+//Constructor and de-constructor
+//The model is built per thread after the geometry, the scintillators
+//of the periods are resolved once
+//
+ATLTileCalTBFrozenShowerModel::ATLTileCalTBFrozenShowerModel( const G4String& name )
+    : G4VFastSimulationModel(name),
+      fLibrary(ATLTileCalTBFrozenShowerLibrary::GetInstance()),
+      fShower(nullptr),
+      fEntry{},
+      fHitMaker(new G4FastSimHitMaker) {
+
+    using ATLTileCalTBGeometry::VolumeRole;
+    auto volumeRoles = ATLTileCalTBGeometry::VolumeRoleTable::GetInstance();
+    for ( auto volume : *G4LogicalVolumeStore::GetInstance() ) {
+        if ( !volumeRoles->HasAnyRole( volume, VolumeRole::Period ) ) continue;
+        //The periods are stacked along their thinnest local axis
+        G4ThreeVector solidMin, solidMax;
+        volume->GetSolid()->BoundingLimits( solidMin, solidMax );
+        const auto extent = solidMax - solidMin;
+        std::size_t axis = 0;
+        for ( std::size_t i = 1; i < 3; ++i ) {
+            if ( extent[i] < extent[axis] ) axis = i;
+        }
+        Period period{volume, axis, solidMin[axis], {}};
+        //Scintillators are placed in wrappers
+        for ( std::size_t i = 0; i < volume->GetNoDaughters(); ++i ) {
+            const auto wrapperPV = volume->GetDaughter(i);
+            const auto wrapperLV = wrapperPV->GetLogicalVolume();
+            for ( std::size_t j = 0; j < wrapperLV->GetNoDaughters(); ++j ) {
+                const auto scintillatorPV = wrapperLV->GetDaughter(j);
+                if ( !volumeRoles->HasAnyRole( scintillatorPV->GetLogicalVolume(), VolumeRole::Scintillator ) ) continue;
+                period.rows.emplace_back( wrapperPV->GetTranslation().z() + scintillatorPV->GetTranslation().z(),
+                                          scintillatorPV->GetCopyNo() );
+            }
+        }
+        fPeriods.push_back( period );
+    }
+
+}
+
+ATLTileCalTBFrozenShowerModel::~ATLTileCalTBFrozenShowerModel() {
+    delete fHitMaker;
+}
+
+//IsApplicable base method
+//
+G4bool ATLTileCalTBFrozenShowerModel::IsApplicable( const G4ParticleDefinition& particle ) {
+    return &particle == G4Electron::ElectronDefinition()
+        || &particle == G4Positron::PositronDefinition()
+        || &particle == G4Gamma::GammaDefinition();
+}
+
+//ModelTrigger base method
+//
+G4bool ATLTileCalTBFrozenShowerModel::ModelTrigger( const G4FastTrack& fastTrack ) {
+
+    fShower = nullptr;
+    const bool generating = fLibrary->IsGenerating();
+    if ( !generating && !fLibrary->IsLoaded() ) return false;
+
+    const auto track = fastTrack.GetPrimaryTrack();
+    using ATLTileCalTBGeometry::VolumeRole;
+    if ( !ATLTileCalTBGeometry::VolumeRoleTable::GetInstance()->HasAnyRole( track->GetVolume()->GetLogicalVolume(), VolumeRole::Period ) ) {
+        return false;
+    }
+    if ( !FindEntry( track, fEntry ) ) return false;
+    const auto energy = track->GetKineticEnergy();
+
+    //Generation mode: the primary particle is simulated, its
+    //deposits are recorded from its entry in the first period
+    //
+    if ( generating ) {
+        auto recorder = ATLTileCalTBFrozenShowerRecorder::GetInstance();
+        if ( track->GetParentID() == 0 && !recorder->IsStarted() && fLibrary->InGenerationRange( energy ) ) {
+            recorder->Start( fEntry, energy );
+        }
+        return false;
+    }
+
+    fShower = fLibrary->Lookup( energy, fEntry );
+    return fShower != nullptr;
+
+}
+
+//DoIt base method
+//
+void ATLTileCalTBFrozenShowerModel::DoIt( const G4FastTrack& fastTrack, G4FastStep& fastStep ) {
+
+    const auto track = fastTrack.GetPrimaryTrack();
+    const auto energy = track->GetKineticEnergy();
+    G4double depositedEnergy = energy;
+    //A positron annihilates at the end of the shower
+    if ( track->GetParticleDefinition() == G4Positron::PositronDefinition() ) depositedEnergy += 2.*electron_mass_c2;
+
+    fastStep.KillPrimaryTrack();
+    fastStep.ProposePrimaryTrackPathLength( 0. );
+    fastStep.ProposeTotalEnergyDeposited( depositedEnergy );
+
+    //Same frame as the recorder: the origin is moved along the period
+    //axis to the recorded phase (at most one period) and the spots are
+    //turned around the axis by the azimuth difference, which leaves the
+    //layers of the periods unchanged. The spot energies are rescaled
+    //from the energy of the library shower
+    //
+    const auto axis = fEntry.axis;
+    const auto lateral1 = (axis + 1) % 3;
+    const auto lateral2 = (axis + 2) % 3;
+    auto origin = fEntry.position;
+    origin[axis] += fShower->phase - fEntry.phase;
+    const G4double rotation = fEntry.azimuth - fShower->azimuth;
+    const G4double cosRotation = std::cos( rotation );
+    const G4double sinRotation = std::sin( rotation );
+    const auto toGlobal = fEntry.toLocal.Inverse();
+
+    const auto spots = fLibrary->GetSpots( fShower );
+    for ( std::uint32_t i = 0; i < fShower->noOfSpots; ++i ) {
+        const auto& spot = spots[i];
+        auto spotPosition = origin;
+        spotPosition[axis] += spot.axial;
+        spotPosition[lateral1] += cosRotation * spot.lateral1 - sinRotation * spot.lateral2;
+        spotPosition[lateral2] += sinRotation * spot.lateral1 + cosRotation * spot.lateral2;
+        fHitMaker->make( G4FastHit( toGlobal.TransformPoint( spotPosition ), spot.energyFraction * energy ), fastTrack );
+    }
+
+}
+
+//FindEntry method
+//The radial axis of the periods is their local z axis
+//
+G4bool ATLTileCalTBFrozenShowerModel::FindEntry( const G4Track* track, ATLTileCalTBFrozenShowerLibrary::Entry& entry ) const {
+    const auto touchable = track->GetTouchable();
+    const auto logical = touchable->GetVolume()->GetLogicalVolume();
+    for ( const auto& period : fPeriods ) {
+        if ( period.logical != logical ) continue;
+        if ( period.rows.empty() ) break;
+        entry.toLocal = touchable->GetHistory()->GetTopTransform();
+        entry.axis = period.axis;
+        entry.position = entry.toLocal.TransformPoint( track->GetPosition() );
+        const auto direction = entry.toLocal.TransformAxis( track->GetMomentumDirection() );
+        entry.phase = entry.position[period.axis] - period.axisMin;
+        entry.cosTheta = direction[period.axis];
+        entry.azimuth = std::atan2( direction[(period.axis + 2) % 3], direction[(period.axis + 1) % 3] );
+        const auto z = entry.position.z();
+        const auto closest = std::min_element( period.rows.begin(), period.rows.end(),
+            [z](const std::pair<G4double, G4int>& lhs, const std::pair<G4double, G4int>& rhs) {
+                return std::abs( lhs.first - z ) < std::abs( rhs.first - z ); } );
+        entry.row = closest->second;
+        return true;
+    }
+    return false;
+}
+
+#endif //ATLTileCalTB_FastSim
+
+//**************************************************
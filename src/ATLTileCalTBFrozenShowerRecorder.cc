@@ -0,0 +1,60 @@
+//**************************************************
+// \file ATLTileCalTBFrozenShowerRecorder.cc
+// \brief: implementation of ATLTileCalTBFrozenShowerRecorder
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+#ifdef ATLTileCalTB_FastSim
+
+//Includers from project files
+//
+#include "ATLTileCalTBFrozenShowerRecorder.hh"
+
+//Constructor
+//
+ATLTileCalTBFrozenShowerRecorder::ATLTileCalTBFrozenShowerRecorder()
+    : fStarted(false),
+      fEntry{},
+      fEnergy(0.) {}
+
+//Start() method
+//
+void ATLTileCalTBFrozenShowerRecorder::Start( const ATLTileCalTBFrozenShowerLibrary::Entry& entry, G4double energy ) {
+    fStarted = true;
+    fEntry = entry;
+    fEnergy = energy;
+    fSpots.clear();
+}
+
+//Record() method
+//The neighbouring periods are translated along the axis of the entry
+//period, their deposits are in the same local frame
+//
+void ATLTileCalTBFrozenShowerRecorder::Record( const G4ThreeVector& position, G4double energy ) {
+    if ( !fStarted || energy <= 0. ) return;
+    const auto distance = fEntry.toLocal.TransformPoint( position ) - fEntry.position;
+    const auto axis = fEntry.axis;
+    fSpots.push_back( {static_cast<float>(distance[axis]), static_cast<float>(distance[(axis + 1) % 3]),
+                       static_cast<float>(distance[(axis + 2) % 3]), static_cast<float>(energy/fEnergy)} );
+}
+
+//EndOfEvent() method
+//
+void ATLTileCalTBFrozenShowerRecorder::EndOfEvent() {
+    if ( fStarted ) ATLTileCalTBFrozenShowerLibrary::GetInstance()->AddShower( fEnergy, fEntry, fSpots );
+    Reset();
+}
+
+//Reset() method
+//
+void ATLTileCalTBFrozenShowerRecorder::Reset() {
+    fStarted = false;
+    fSpots.clear();
+}
+
+#endif //ATLTileCalTB_FastSim
+
+//**************************************************
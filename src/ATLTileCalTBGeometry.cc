@@ -11,6 +11,10 @@
 //
 #include "ATLTileCalTBGeometry.hh"
 
+//Includers from Geant4
+//
+#include "G4LogicalVolumeStore.hh"
+
 //Includers from C++
 //
 #include <sstream>
@@ -61,7 +65,11 @@ std::ostream& ATLTileCalTBGeometry::operator<<(std::ostream& ostream, const Cell
     return ostream;
 }
 
-std::size_t CellLUT::FindCellIndex(Module module, std::size_t rowIdx, std::size_t tileIdx) const {
+// FirstCellOfRow method
+// Index of the first cell of the row (0-based row index) in a module
+// parsable with row and tile indices
+//
+constexpr std::size_t CellLUT::FirstCellOfRow(Module module, std::size_t rowIdx) {
     constexpr std::size_t long_module_no_cells = 45;
     constexpr std::size_t long_module_row_A_lastrow = 3;
     constexpr std::size_t long_module_row_A_no_cells = 20;
@@ -75,22 +83,8 @@ std::size_t CellLUT::FindCellIndex(Module module, std::size_t rowIdx, std::size_
     std::size_t index = 0;
 
     // Fast forward module
-    switch (module) {
-        case Module::LONG_LOWER:
-            break;
-        case Module::LONG_UPPER:
-            index += long_module_no_cells;
-            break;
-        case Module::EXTENDED:
-            index += 2 * long_module_no_cells;
-            break;
-        case Module::EXTENDED_C10:
-            // not parsable with rowIdx and tileIdx, return directly
-            return fNoOfCells - 2;
-        case Module::EXTENDED_D4:
-            // not parsable with rowIdx and tileIdx, return directly
-            return fNoOfCells - 1;
-    }
+    if ( module == Module::LONG_UPPER ) index += long_module_no_cells;
+    if ( module == Module::EXTENDED ) index += 2 * long_module_no_cells;
 
     // Row indecies start with 1 in ATLAS convention
     rowIdx += 1;
@@ -105,7 +99,6 @@ std::size_t CellLUT::FindCellIndex(Module module, std::size_t rowIdx, std::size_
         }
     }
     else {
-        // Note: ignore ITC module as handled before
         if ( rowIdx > extended_module_row_A_lastrow ) {
             index += extended_module_A_no_cells;
         }
@@ -114,34 +107,159 @@ std::size_t CellLUT::FindCellIndex(Module module, std::size_t rowIdx, std::size_
         }
     }
 
-    // Get index for nTilesRow, stays constant in a row
-    const std::size_t n_tiles_row_index = rowIdx - GetCell(index).firstRow;
+    return index;
+}
 
-    //G4cout << "row " << rowIdx << " fast-forwarded index " << index << " " << GetCell(index).to_string() << G4endl;
+// NumberOfPeriods method
+// Tiles of all the cells of a row, the cells of a row share the first row
+//
+constexpr std::size_t CellLUT::NumberOfPeriods(Module module, std::size_t rowIdx) {
+    const auto first = FirstCellOfRow(module, rowIdx);
+    const std::size_t n_tiles_row_index = rowIdx + 1 - fCellVector[first].firstRow;
+    std::size_t periods = 0;
+    for ( auto index = first; index < fNoOfCells && fCellVector[index].module == module
+          && fCellVector[index].firstRow == fCellVector[first].firstRow; ++index ) {
+        periods += fCellVector[index].nTilesRow[n_tiles_row_index];
+    }
+    return periods;
+}
+
+// ScanCellIndex method
+// Reference algorithm: count through the cells of the row and compare to periods
+//
+constexpr std::size_t CellLUT::ScanCellIndex(Module module, std::size_t rowIdx, std::size_t tileIdx) {
+    std::size_t index = FirstCellOfRow(module, rowIdx);
+
+    // Get index for nTilesRow, stays constant in a row
+    const std::size_t n_tiles_row_index = rowIdx + 1 - fCellVector[index].firstRow;
 
-    // Count trough cells and comapre to periods
     --index;
     std::size_t counter = 0;
     std::size_t next_cell_count = 0;
     do {
         ++index;
         counter += next_cell_count;
-        next_cell_count = GetCell(index).nTilesRow[n_tiles_row_index];
-        //G4cout << "index " << index << " counter " << counter << " next_cell_count " << next_cell_count << " sum " << counter + next_cell_count << G4endl;
+        next_cell_count = fCellVector[index].nTilesRow[n_tiles_row_index];
     }
     while ( tileIdx >= counter + next_cell_count );
 
+    return index;
+}
+
+// BuildCellTable method
+// Each cell fills the tile indices of its tiles in every row
+//
+constexpr CellLUT::CellTable CellLUT::BuildCellTable() {
+    CellTable table {};
+    for ( auto& module_table : table ) {
+        for ( auto& row_table : module_table ) {
+            for ( auto& cell_index : row_table ) { cell_index = fInvalidCell; }
+        }
+    }
+
+    for ( std::size_t module_index = 0; module_index < fNoOfTableModules; ++module_index ) {
+        const auto module = static_cast<Module>(module_index);
+        for ( std::size_t rowIdx = 0; rowIdx < fNoOfRows; ++rowIdx ) {
+            const auto first = FirstCellOfRow(module, rowIdx);
+            const std::size_t n_tiles_row_index = rowIdx + 1 - fCellVector[first].firstRow;
+            std::size_t tileIdx = 0;
+            for ( auto index = first; index < fNoOfCells && fCellVector[index].module == module
+                  && fCellVector[index].firstRow == fCellVector[first].firstRow; ++index ) {
+                for ( std::size_t tile = 0; tile < fCellVector[index].nTilesRow[n_tiles_row_index]; ++tile ) {
+                    table[module_index][rowIdx][tileIdx++] = static_cast<std::uint8_t>(index);
+                }
+            }
+        }
+    }
+
+    return table;
+}
+
+// CheckCellTable method
+// The table must give the cell of the reference algorithm for every tile of the module
+//
+constexpr bool CellLUT::CheckCellTable(Module module) {
+    const auto table = BuildCellTable();
+    const auto module_index = static_cast<std::size_t>(module);
+    for ( std::size_t rowIdx = 0; rowIdx < fNoOfRows; ++rowIdx ) {
+        const auto periods = NumberOfPeriods(module, rowIdx);
+        for ( std::size_t tileIdx = 0; tileIdx < fMaxPeriods; ++tileIdx ) {
+            const auto cell_index = table[module_index][rowIdx][tileIdx];
+            if ( tileIdx < periods && cell_index != ScanCellIndex(module, rowIdx, tileIdx) ) return false;
+            if ( tileIdx >= periods && cell_index != fInvalidCell ) return false;
+        }
+    }
+    return true;
+}
+
+const CellLUT::CellTable CellLUT::fCellTable = CellLUT::BuildCellTable();
+
+// FindCellIndex method
+// Constant-time lookup in the compile-time table
+//
+std::size_t CellLUT::FindCellIndex(Module module, std::size_t rowIdx, std::size_t tileIdx) const {
+    // Compile-time self-check of the table against the reference algorithm
+    static_assert(static_cast<std::size_t>(Module::LONG_LOWER) == 0 && static_cast<std::size_t>(Module::LONG_UPPER) == 1
+                  && static_cast<std::size_t>(Module::EXTENDED) == 2, "CellLUT table modules must come first in Module");
+    static_assert(CheckCellTable(Module::LONG_LOWER), "CellLUT table differs from the scan for the lower long module");
+    static_assert(CheckCellTable(Module::LONG_UPPER), "CellLUT table differs from the scan for the upper long module");
+    static_assert(CheckCellTable(Module::EXTENDED), "CellLUT table differs from the scan for the extended module");
+
+    switch (module) {
+        case Module::EXTENDED_C10:
+            // not parsable with rowIdx and tileIdx, return directly
+            return fNoOfCells - 2;
+        case Module::EXTENDED_D4:
+            // not parsable with rowIdx and tileIdx, return directly
+            return fNoOfCells - 1;
+        default:
+            break;
+    }
+
+    std::size_t index = SIZE_MAX;
+    if ( rowIdx < fNoOfRows && tileIdx < fMaxPeriods ) {
+        const auto cell_index = fCellTable[static_cast<std::size_t>(module)][rowIdx][tileIdx];
+        if ( cell_index != fInvalidCell ) index = cell_index;
+    }
+
     // Sanity check
     if (index >= fNoOfCells) {
         G4ExceptionDescription msg;
-        msg << "Cell with index " << index << " does not exist, row index " << rowIdx << " and tile index " << tileIdx
+        msg << "Cell with index " << index << " does not exist, row index " << rowIdx + 1 << " and tile index " << tileIdx
             << " are probably out of range." << G4endl;
         G4Exception("ATLTileCalTBGeometry::CellLUT::FindCellIndex",
         "MyCode0007", FatalException, msg);
         return SIZE_MAX; // Return impossible size
     }
 
-    //G4cout << GetCell(index).to_string() << G4endl;
-
     return index;
 }
+
+// Build method
+// Logical volumes are matched by name once, the GDML parser strips
+// the pointer suffix from the names
+//
+void VolumeRoleTable::Build() {
+    auto LVStore = G4LogicalVolumeStore::GetInstance();
+    fRoles.clear();
+    for (auto volume : *LVStore) {
+        const auto id = static_cast<std::size_t>(volume->GetInstanceID());
+        if (id >= fRoles.size()) fRoles.resize(id + 1, static_cast<std::uint8_t>(VolumeRole::None));
+
+        auto role = VolumeRole::None;
+        const auto& name = volume->GetName();
+        if (name == "CALO::CALO") role = VolumeRole::CaloEnvelope;
+        else if (name == "Tile::Barrel") role = VolumeRole::Barrel;
+        else if (name == "Tile::Absorber") role = VolumeRole::Absorber;
+        else if (name == "Tile::Scintillator") role = VolumeRole::Scintillator;
+        else if (name == "Tile::GirderMother" || name == "Tile::Finger" || name == "Tile::EFinger") role = VolumeRole::GirderFinger;
+        else if (name == "BEAMPIPE1::BEAMPIPE1" || name == "BEAMPIPE2::BEAMPIPE2" || name == "S1::S1"
+                 || name == "S2::S2" || name == "S3::S3") role = VolumeRole::Beamline;
+        else if (name == "Tile::BarrelModule" || name == "Tile::EBarrelModule" || name == "Tile::ITCModule"
+                 || name == "Tile::Plug1Module" || name == "Tile::Plug2Module") role = VolumeRole::Module;
+        else if (name == "Tile::Period") role = VolumeRole::Period;
+        fRoles[id] = static_cast<std::uint8_t>(role);
+    }
+}
+
+//**************************************************
@@ -10,39 +10,96 @@
 //
 #include "ATLTileCalTBHit.hh"
 #include "ATLTileCalTBConstants.hh"
+#include "ATLTileCalTBTimeBinning.hh"
+#ifndef ATLTileCalTB_SparseHits
+#include "ATLTileCalTBSignalBuffer.hh"
+#endif
 
 //Includers from Geant4
 #include "G4UnitsTable.hh"
+#ifdef ATLTileCalTB_DeferredPoisson
+#include "G4Poisson.hh"
+#endif
+
+//Includers from C++
+//
+#include <algorithm>
+#ifdef ATLTileCalTB_DeferredPoisson
+#include <tuple>
+#endif
+
+G4ThreadLocal G4Allocator<ATLTileCalTBHit>* ATLTileCalTBHitAllocator = nullptr;
 
 //Constructor and de-constructor
 //
+#ifdef ATLTileCalTB_SparseHits
 ATLTileCalTBHit::ATLTileCalTBHit()
     : G4VHit(),
       fEdep(0.),
-      fSdepUp(),
-      fSdepDown() {
-    fSdepUp.fill(0.);
-    fSdepDown.fill(0.);
-
+      fFirstFrame(SIZE_MAX),
+      fLastFrame(0) {}
+#else
+ATLTileCalTBHit::ATLTileCalTBHit( ATLTileCalTBSignalBuffer& buffer, std::size_t cellIndex )
+    : G4VHit(),
+      fEdep(0.),
+      fBuffer(&buffer),
+      fCellIndex(cellIndex),
+      fFirstFrame(SIZE_MAX),
+      fLastFrame(0) {
+    auto signal = buffer.Acquire(cellIndex, this);
+    fSdepUp = signal.up;
+    fSdepDown = signal.down;
 }
+#endif
 
+#ifdef ATLTileCalTB_SparseHits
 ATLTileCalTBHit::~ATLTileCalTBHit() {}
 
 ATLTileCalTBHit::ATLTileCalTBHit(const ATLTileCalTBHit& right)
     : G4VHit() {
     fEdep = right.fEdep;
-    fSdepUp = std::array<G4double, ATLTileCalTBConstants::frames>(right.fSdepUp);
-    fSdepDown = std::array<G4double, ATLTileCalTBConstants::frames>(right.fSdepDown);
+    fSdepEntries = right.fSdepEntries;
+    #ifdef ATLTileCalTB_DeferredPoisson
+    fExpectedPe = right.fExpectedPe;
+    #endif
+    fFirstFrame = right.fFirstFrame;
+    fLastFrame = right.fLastFrame;
+
+}
+#else
+ATLTileCalTBHit::~ATLTileCalTBHit() { ReleaseView(); }
+
+ATLTileCalTBHit::ATLTileCalTBHit(const ATLTileCalTBHit& right)
+    : G4VHit(),
+      fBuffer(nullptr),
+      fCellIndex(0) {
+    fEdep = right.fEdep;
+    CopySignal(right);
+    #ifdef ATLTileCalTB_DeferredPoisson
+    fExpectedPe = right.fExpectedPe;
+    #endif
+    fFirstFrame = right.fFirstFrame;
+    fLastFrame = right.fLastFrame;
 
 }
+#endif
 
 //Operator = definition
 //
 const ATLTileCalTBHit& ATLTileCalTBHit::operator=(const ATLTileCalTBHit& right) {
   
+    if ( this == &right ) return *this;
     fEdep = right.fEdep;
-    fSdepUp = std::array<G4double, ATLTileCalTBConstants::frames>(right.fSdepUp);
-    fSdepDown = std::array<G4double, ATLTileCalTBConstants::frames>(right.fSdepDown);
+    #ifdef ATLTileCalTB_SparseHits
+    fSdepEntries = right.fSdepEntries;
+    #else
+    CopySignal(right);
+    #endif
+    #ifdef ATLTileCalTB_DeferredPoisson
+    fExpectedPe = right.fExpectedPe;
+    #endif
+    fFirstFrame = right.fFirstFrame;
+    fLastFrame = right.fLastFrame;
 
     return *this;
 
@@ -56,12 +113,116 @@ G4bool ATLTileCalTBHit::operator==(const ATLTileCalTBHit& right) const {
 
 }
 
+#ifndef ATLTileCalTB_SparseHits
+//CopySignal() method
+//Only the bins with a signal are copied, the owned bins are zeroed
+//
+void ATLTileCalTBHit::CopySignal( const ATLTileCalTBHit& source ) {
+    const auto bins = ATLTileCalTBTimeBinning::GetInstance()->GetNoOfBins();
+    const std::array<const SdepValue*, 2> signals {source.fSdepUp, source.fSdepDown};
+    std::unique_ptr<SdepValue[]> owned(new SdepValue[signals.size() * bins]());
+    if ( source.IsActive() ) {
+        for ( std::size_t i = 0; i < signals.size(); ++i ) {
+            std::copy(signals[i] + source.fFirstFrame, signals[i] + source.fLastFrame + 1,
+                      owned.get() + i * bins + source.fFirstFrame);
+        }
+    }
+    ReleaseView();
+    fOwned = std::move(owned);
+    fSdepUp = fOwned.get();
+    fSdepDown = fOwned.get() + bins;
+}
+
+//ReleaseView() method
+//The written bins are zeroed for the next hit of the cell
+//
+void ATLTileCalTBHit::ReleaseView() {
+    if ( ! fBuffer ) return;
+    if ( IsActive() ) {
+        std::fill(fSdepUp + fFirstFrame, fSdepUp + fLastFrame + 1, 0);
+        std::fill(fSdepDown + fFirstFrame, fSdepDown + fLastFrame + 1, 0);
+    }
+    fBuffer->Release(fCellIndex);
+    fBuffer = nullptr;
+}
+
+//Detach() method
+//Called by the signal buffer before the cell is given to a new hit,
+//e.g. for the hits of a kept event
+//
+void ATLTileCalTBHit::Detach() {
+    if ( fBuffer ) CopySignal(*this);
+}
+#endif
+
+#ifdef ATLTileCalTB_SparseHits
+//Coalesce() method
+//Interleaved tracks leave several entries per frame, the sparse
+//convolution costs one response per entry
+//
+void ATLTileCalTBHit::Coalesce() {
+    if ( fSdepEntries.size() < 2 ) return;
+    auto byFrame = [](const SdepEntry& lhs, const SdepEntry& rhs) { return lhs.frame < rhs.frame; };
+    if ( ! std::is_sorted( fSdepEntries.begin(), fSdepEntries.end(), byFrame ) ) {
+        std::sort( fSdepEntries.begin(), fSdepEntries.end(), byFrame );
+    }
+    auto last = fSdepEntries.begin();
+    for ( auto entry = fSdepEntries.begin() + 1; entry != fSdepEntries.end(); ++entry ) {
+        if ( entry->frame == last->frame ) {
+            last->up += entry->up;
+            last->down += entry->down;
+        }
+        else *(++last) = *entry;
+    }
+    fSdepEntries.erase( last + 1, fSdepEntries.end() );
+}
+#endif
+
+#ifdef ATLTileCalTB_SubEvent
+//Merge() method
+//Only with the sparse layout, the sub-event entries are appended
+//and coalesced with the entries of the same frame
+//
+void ATLTileCalTBHit::Merge( const ATLTileCalTBHit& subEventHit ) {
+    fEdep += subEventHit.fEdep;
+    if ( ! subEventHit.IsActive() ) return;
+    fSdepEntries.insert( fSdepEntries.end(), subEventHit.fSdepEntries.begin(), subEventHit.fSdepEntries.end() );
+    Coalesce();
+    if ( subEventHit.fFirstFrame < fFirstFrame ) fFirstFrame = subEventHit.fFirstFrame;
+    if ( subEventHit.fLastFrame > fLastFrame ) fLastFrame = subEventHit.fLastFrame;
+}
+#endif
+
+#ifdef ATLTileCalTB_DeferredPoisson
+//SamplePhotoelectrons() method
+//The photoelectrons of the deposits with the same frame and U-shape
+//response are the sum of their Poisson photoelectrons, i.e. Poisson
+//distributed with the summed expectation. Each photoelectron keeps the
+//U-shape response of its deposit as with the per-step sampling.
+//
+void ATLTileCalTBHit::SamplePhotoelectrons() {
+    if ( fExpectedPe.empty() ) return;
+    std::sort( fExpectedPe.begin(), fExpectedPe.end(), [](const ExpectedPe& lhs, const ExpectedPe& rhs) {
+        return std::tie(lhs.frame, lhs.uShapeUp, lhs.uShapeDown) < std::tie(rhs.frame, rhs.uShapeUp, rhs.uShapeDown); } );
+    for ( auto entry = fExpectedPe.begin(); entry != fExpectedPe.end(); ) {
+        auto next = entry + 1;
+        G4double lambda = entry->lambda;
+        for ( ; next != fExpectedPe.end() && next->frame == entry->frame && next->uShapeUp == entry->uShapeUp &&
+                next->uShapeDown == entry->uShapeDown; ++next ) lambda += next->lambda;
+        const auto pe = static_cast<G4double>(G4Poisson(lambda));
+        AddSdep(static_cast<std::size_t>(entry->frame), pe * entry->uShapeUp, pe * entry->uShapeDown);
+        entry = next;
+    }
+    fExpectedPe.clear();
+}
+#endif
+
 //ATLTileCalTBHit::GetBinFromTime method
 //
 std::size_t ATLTileCalTBHit::GetBinFromTime( G4double time ) {
-    using namespace ATLTileCalTBConstants;
-    if ( time < frame_time_window ) {
-        return static_cast<std::size_t>(std::ceil(time / frame_bin_time));
+    auto bin = ATLTileCalTBTimeBinning::GetInstance()->GetBin(time);
+    if ( bin != SIZE_MAX ) {
+        return bin;
     }
     else {
         G4ExceptionDescription msg;
@@ -0,0 +1,194 @@
+//**************************************************
+// \file ATLTileCalTBMPI.cc
+// \brief: implementation of ATLTileCalTBMPI
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+#ifdef ATLTileCalTB_MPI
+
+//Includers from project files
+//
+#include "ATLTileCalTBMPI.hh"
+
+//Includers from Geant4
+//
+#include "G4ios.hh"
+#include "G4AutoLock.hh"
+
+//Includers from ROOT
+//
+#include "TFileMerger.h"
+
+//Includers from C++
+//
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+#include <vector>
+
+//GetInstance() method
+//One instance per process
+//
+ATLTileCalTBMPI* ATLTileCalTBMPI::GetInstance() {
+    static ATLTileCalTBMPI instance;
+    return &instance;
+}
+
+//Constructor and de-constructor
+//
+ATLTileCalTBMPI::ATLTileCalTBMPI()
+    : fRank(0),
+      fSize(1),
+      fGrain(10),
+      fEvents(0),
+      fNext(0),
+      fEnd(0),
+      fSimulated(0),
+      fCounter(nullptr),
+      fWindow(MPI_WIN_NULL) {
+
+    //Smaller chunks balance the ranks better at the price of
+    //more requests to rank 0
+    //
+    fMessenger = new G4GenericMessenger(this, "/ATLTileCalTB/mpi/", "MPI-distributed runs");
+    fMessenger->DeclareProperty("grain", fGrain,
+        "Number of events a rank takes at once")
+        .SetParameterName("events", false)
+        .SetRange("events>=1")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+
+}
+
+ATLTileCalTBMPI::~ATLTileCalTBMPI() {
+    delete fMessenger;
+}
+
+//Initialize() method
+//The worker threads call MPI one at a time
+//
+void ATLTileCalTBMPI::Initialize( int* argc, char*** argv ) {
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Init_thread( argc, argv, MPI_THREAD_SERIALIZED, &provided );
+    if ( provided < MPI_THREAD_SERIALIZED ) {
+        G4ExceptionDescription msg;
+        msg << "The MPI library does not support MPI_THREAD_SERIALIZED." << G4endl;
+        G4Exception("ATLTileCalTBMPI::Initialize()",
+        "MyCode0013", FatalException, msg);
+    }
+    MPI_Comm_rank( MPI_COMM_WORLD, &fRank );
+    MPI_Comm_size( MPI_COMM_WORLD, &fSize );
+    MPI_Win_allocate( fRank == 0 ? sizeof(long) : 0, sizeof(long), MPI_INFO_NULL, MPI_COMM_WORLD,
+                      &fCounter, &fWindow );
+}
+
+//Finalize() method
+//
+void ATLTileCalTBMPI::Finalize() {
+    MPI_Win_free( &fWindow );
+    MPI_Finalize();
+}
+
+//BeginOfRun() method
+//The barriers keep the ranks from taking events before the
+//counter is reset
+//
+void ATLTileCalTBMPI::BeginOfRun( G4int events ) {
+    G4AutoLock lock(&fMutex);
+    fEvents = events;
+    fNext = 0;
+    fEnd = 0;
+    fSimulated = 0;
+    MPI_Barrier( MPI_COMM_WORLD );
+    if ( fRank == 0 ) {
+        long zero = 0;
+        MPI_Win_lock( MPI_LOCK_EXCLUSIVE, 0, 0, fWindow );
+        MPI_Accumulate( &zero, 1, MPI_LONG, 0, 0, 1, MPI_LONG, MPI_REPLACE, fWindow );
+        MPI_Win_unlock( 0, fWindow );
+    }
+    MPI_Barrier( MPI_COMM_WORLD );
+}
+
+//NextEvent() method
+//
+G4int ATLTileCalTBMPI::NextEvent() {
+    G4AutoLock lock(&fMutex);
+    if ( fNext >= fEnd ) {
+        if ( fEnd >= fEvents ) return -1; //the run has no events left
+        long grain = fGrain;
+        long first = 0;
+        MPI_Win_lock( MPI_LOCK_SHARED, 0, 0, fWindow );
+        MPI_Fetch_and_op( &grain, &first, MPI_LONG, 0, 0, MPI_SUM, fWindow );
+        MPI_Win_unlock( 0, fWindow );
+        fNext = first;
+        fEnd = std::min<G4long>( first + grain, fEvents );
+        if ( fNext >= fEnd ) {
+            fEnd = fEvents;
+            return -1;
+        }
+    }
+    ++fSimulated;
+    return static_cast<G4int>(fNext++);
+}
+
+//EndOfRun() method
+//Rank 0 gets the event counts of all the ranks once they have
+//closed their output
+//
+void ATLTileCalTBMPI::EndOfRun( const G4String& name ) {
+    G4AutoLock lock(&fMutex);
+    long simulated = fSimulated;
+    std::vector<long> rankEvents( fRank == 0 ? fSize : 0 );
+    MPI_Gather( &simulated, 1, MPI_LONG, rankEvents.data(), 1, MPI_LONG, 0, MPI_COMM_WORLD );
+    if ( fRank != 0 ) return;
+
+    auto events = std::minmax_element( rankEvents.begin(), rankEvents.end() );
+    G4cout << "  MPI ranks: " << fSize << ", events per rank min/max: " << *events.first << "/" << *events.second
+           << ", total: " << std::accumulate( rankEvents.begin(), rankEvents.end(), 0L ) << G4endl;
+    #ifndef ATLTileCalTB_ThreadFiles
+    MergeOutputs( name );
+    #endif
+}
+
+//MergeOutputs() method
+//The rank outputs are removed once merged
+//
+void ATLTileCalTBMPI::MergeOutputs( const G4String& name ) const {
+    TFileMerger merger( false );
+    merger.SetPrintLevel( 0 );
+    G4bool merged = merger.OutputFile( (name + ".root").c_str(), "RECREATE" );
+    for ( G4int rank = 0; rank < fSize && merged; ++rank ) {
+        merged = merger.AddFile( (name + "_Rank" + std::to_string(rank) + ".root").c_str(), false );
+    }
+    merged = merged && merger.Merge();
+    if ( !merged ) {
+        G4ExceptionDescription msg;
+        msg << "Could not merge the rank outputs into " << name << ".root, rank outputs kept." << G4endl;
+        G4Exception("ATLTileCalTBMPI::MergeOutputs()",
+        "MyCode0014", JustWarning, msg);
+        return;
+    }
+    for ( G4int rank = 0; rank < fSize; ++rank ) {
+        std::filesystem::remove( name + "_Rank" + std::to_string(rank) + ".root" );
+    }
+}
+
+//GetFileSuffix() method
+//
+G4String ATLTileCalTBMPI::GetFileSuffix() const {
+    return "_Rank" + std::to_string(fRank);
+}
+
+//Print() method
+//
+void ATLTileCalTBMPI::Print() const {
+    if ( fRank != 0 ) return;
+    G4cout << "MPI run across " << fSize << " ranks, " << fGrain << " events per request" << G4endl;
+}
+
+#endif //ATLTileCalTB_MPI
+
+//**************************************************
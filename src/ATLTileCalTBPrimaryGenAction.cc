@@ -10,6 +10,11 @@
 //Includers from project files
 //
 #include "ATLTileCalTBPrimaryGenAction.hh"
+#include "ATLTileCalTBShard.hh"
+#include "ATLTileCalTBEventInformation.hh"
+#ifdef ATLTileCalTB_MPI
+#include "ATLTileCalTBMPI.hh"
+#endif
 
 //Includers from Geant4
 //
@@ -18,6 +23,8 @@
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
 
 //Constructor and de-constructor
 //
@@ -49,6 +56,26 @@ ATLTileCalTBPrimaryGenAction::~ATLTileCalTBPrimaryGenAction() {
 //
 void ATLTileCalTBPrimaryGenAction::GeneratePrimaries( G4Event* event ){
 
+    //Sharded and MPI runs: events of other shards or ranks are left
+    //empty, the others are seeded from their run and event IDs
+    //
+    auto shard = ATLTileCalTBShard::GetInstance();
+    const auto runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+    #ifdef ATLTileCalTB_MPI
+    const auto eventID = ATLTileCalTBMPI::GetInstance()->NextEvent();
+    if ( eventID < 0 ) return;
+    shard->Reseed( runID, eventID );
+    #else
+    const auto eventID = event->GetEventID();
+    if ( shard->IsActive() ) {
+        if ( !shard->Owns( eventID ) ) return;
+        shard->Reseed( runID, eventID );
+    }
+    #endif
+
+    //The event information marks the events to be written
+    event->SetUserInformation( new ATLTileCalTBEventInformation( eventID,
+        fParticleGun->GetParticleDefinition()->GetPDGEncoding(), fParticleGun->GetParticleEnergy() ) );
     fParticleGun->GeneratePrimaryVertex( event );
 
 }
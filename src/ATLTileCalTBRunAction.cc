@@ -11,16 +11,32 @@
 //
 #include "ATLTileCalTBRunAction.hh"
 #include "ATLTileCalTBEventAction.hh"
+#include "ATLTileCalTBTimeBinning.hh"
+#include "ATLTileCalTBCulling.hh"
+#include "ATLTileCalTBShard.hh"
+#ifdef ATLTileCalTB_DigiBenchmark
+#include "ATLTileCalTBVDigitizer.hh"
+#endif
+#ifdef ATLTileCalTB_FastSim
+#include "ATLTileCalTBEMShowerParameters.hh"
+#include "ATLTileCalTBFrozenShowerLibrary.hh"
+#endif
 #ifdef ATLTileCalTB_LEAKANALYSIS
 #include "SpectrumAnalyzer.hh"
 #endif
+#ifdef ATLTileCalTB_MPI
+#include "ATLTileCalTBMPI.hh"
+#endif
 
 //Includers from Geant4
 //
 #include "G4Run.hh"
 #include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4AccumulableManager.hh"
 #include "G4Version.hh"
+#include "G4AutoLock.hh"
 #if G4VERSION_NUMBER < 1100
 #include "g4root.hh"  // replaced by G4AnalysisManager.h  in G4 v11 and up
 #else
@@ -30,23 +46,51 @@
 //Includers from C++
 //
 #include <filesystem>
+#include <chrono>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace {
+    //Scaling report: start of the run on the master and number of
+    //events and finish time (s) of each worker thread. The workers
+    //of the tasking run managers end their run only when the master
+    //terminates it, their finish time is the end of their last event.
+    //
+    G4Mutex threadTimesMutex = G4MUTEX_INITIALIZER;
+    std::chrono::steady_clock::time_point runStart;
+    std::vector<std::pair<G4int, G4double>> threadFinishTimes;
+}
 
 //Constructor and de-constructor
 //
 ATLTileCalTBRunAction::ATLTileCalTBRunAction( ATLTileCalTBEventAction* eventAction )
     : G4UserRunAction(),
-      fEventAction(eventAction) { 
+      fEventAction(eventAction),
+      fCulledTracks("CulledTracks", 0),
+      fCulledEnergy("CulledEnergy", 0.) { 
     
     //Printing event number per each event
     //
     G4RunManager::GetRunManager()->SetPrintProgress(100);
 
+    //Register the culling counters, merged from the workers at end of run
+    //
+    auto accumulableManager = G4AccumulableManager::Instance();
+    accumulableManager->RegisterAccumulable(fCulledTracks);
+    accumulableManager->RegisterAccumulable(fCulledEnergy);
+
     //Get analysis manager
     //
     auto analysisManager = G4AnalysisManager::Instance();
 
     analysisManager->SetVerboseLevel(1);
+    #ifdef ATLTileCalTB_ThreadFiles
+    //Each worker writes ATLTileCalTBout_Run<run>_t<thread>.root
+    analysisManager->SetNtupleMerging(false);
+    #else
     analysisManager->SetNtupleMerging(true);
+    #endif
 
     #if G4VERSION_NUMBER > 1050
     analysisManager->SetNtupleRowWise(false);
@@ -63,6 +107,8 @@ ATLTileCalTBRunAction::ATLTileCalTBRunAction( ATLTileCalTBEventAction* eventActi
     analysisManager->CreateNtupleDColumn("Sdep", fEventAction->GetSdepVector());
     analysisManager->CreateNtupleIColumn("PDGID");
     analysisManager->CreateNtupleFColumn("EBeam");
+    analysisManager->CreateNtupleDColumn("Phase", fEventAction->GetPhaseVector());
+    analysisManager->CreateNtupleIColumn("EventID");
     analysisManager->FinishNtuple();
     
     #ifdef ATLTileCalTB_LEAKANALYSIS
@@ -80,6 +126,7 @@ ATLTileCalTBRunAction::~ATLTileCalTBRunAction() {
 //
 void ATLTileCalTBRunAction::BeginOfRunAction(const G4Run* run) { 
     fTimer.Start(); 
+    G4AccumulableManager::Instance()->Reset();
     
     //Save random number seed
     //
@@ -88,12 +135,23 @@ void ATLTileCalTBRunAction::BeginOfRunAction(const G4Run* run) {
     auto analysisManager = G4AnalysisManager::Instance();
 
     std::string runnumber = std::to_string( run->GetRunID() );
-    G4String fileName = "ATLTileCalTBout_Run" + runnumber + ".root";
-    analysisManager->OpenFile(fileName);
+    #ifdef ATLTileCalTB_MPI
+    //The ranks share the events of the run, rank 0 merges their outputs
+    if (IsMaster()) ATLTileCalTBMPI::GetInstance()->BeginOfRun( run->GetNumberOfEventToBeProcessed() );
+    G4String fileName = "ATLTileCalTBout_Run" + runnumber + ATLTileCalTBMPI::GetInstance()->GetFileSuffix() + ".root";
+    #else
+    G4String fileName = "ATLTileCalTBout_Run" + runnumber + ATLTileCalTBShard::GetInstance()->GetFileSuffix() + ".root";
+    #endif
+    if ( HasOutputFile() ) analysisManager->OpenFile(fileName);
 
     //Print useful information
     //
     if (IsMaster()) {
+        {
+            G4AutoLock lock(&threadTimesMutex);
+            runStart = std::chrono::steady_clock::now();
+            threadFinishTimes.clear();
+        }
         G4cout << "Using " << analysisManager->GetType() << G4endl;
         #ifdef ATLTileCalTB_PulseOutput
         G4cout << "Creating pulse plots" << G4endl;
@@ -101,6 +159,19 @@ void ATLTileCalTBRunAction::BeginOfRunAction(const G4Run* run) {
         #ifdef ATLTileCalTB_NoNoise
         G4cout << "Electronic noise disabled" << G4endl;
         #endif
+        ATLTileCalTBTimeBinning::GetInstance()->Print();
+        ATLTileCalTBCulling::GetInstance()->Print();
+        ATLTileCalTBShard::GetInstance()->Print();
+        #ifdef ATLTileCalTB_MPI
+        ATLTileCalTBMPI::GetInstance()->Print();
+        #endif
+        #ifdef ATLTileCalTB_FastSim
+        ATLTileCalTBEMShowerParameters::GetInstance()->Print();
+        ATLTileCalTBFrozenShowerLibrary::GetInstance()->Print();
+        #endif
+        #ifdef ATLTileCalTB_DigiBenchmark
+        ATLTileCalTBVDigitizer::Create()->Benchmark();
+        #endif
     }
 
     auto pulse_run_path = std::filesystem::path("ATLTileCalTBpulse_Run" + runnumber);
@@ -111,21 +182,89 @@ void ATLTileCalTBRunAction::BeginOfRunAction(const G4Run* run) {
 
 }
 
-void ATLTileCalTBRunAction::EndOfRunAction(const G4Run* run) {
+void ATLTileCalTBRunAction::EndOfRunAction([[maybe_unused]] const G4Run* run) {
+
+    //Digitize events left in the batch
+    //
+    fEventAction->FlushDigitization();
 
     auto analysisManager = G4AnalysisManager::Instance();
-    analysisManager->Write();
-    analysisManager->CloseFile();
+    if ( HasOutputFile() ) {
+        analysisManager->Write();
+        analysisManager->CloseFile();
+    }
+
+    //Merge the culling and event counters of the workers
+    //
+    G4AccumulableManager::Instance()->Merge();
 
     //Stop Time and printout time
+    //Sharded and MPI runs leave the events of the other shards or
+    //ranks empty, only the simulated events are counted
     //
     fTimer.Stop();
-    G4int events = run->GetNumberOfEvent();
+    G4int events = fEventAction->GetNoOfSimulatedEvents();
+    if ( !IsMaster() && events > 0 ) {
+        G4AutoLock lock(&threadTimesMutex);
+        const std::chrono::duration<G4double> finishTime = fEventAction->GetLastEventEnd() - runStart;
+        threadFinishTimes.emplace_back( events, finishTime.count() );
+    }
     G4cout << " ====================================================================== " << G4endl;
     G4cout << "  Run terminated, " << events << " events transported" << G4endl;
     G4cout << "  Time: " << fTimer << G4endl;
-    G4cout << "  Time per event(s): " << fTimer.GetUserElapsed() / static_cast<double>(events) << G4endl;
+    if ( events > 0 ) G4cout << "  Time per event(s): " << fTimer.GetUserElapsed() / static_cast<double>(events) << G4endl;
+    if ( ATLTileCalTBCulling::GetInstance()->IsEnabled() ) {
+        G4cout << "  Culled tracks after the time window: " << fCulledTracks.GetValue()
+               << ", kinetic energy: " << G4BestUnit(fCulledEnergy.GetValue(), "Energy") << G4endl;
+    }
+    if ( IsMaster() ) {
+        if ( events > 0 ) G4cout << "  Wall time per event(s): " << fTimer.GetRealElapsed() / static_cast<double>(events) << G4endl;
+        PrintThreadTimes();
+        #ifdef ATLTileCalTB_MPI
+        ATLTileCalTBMPI::GetInstance()->EndOfRun( "ATLTileCalTBout_Run" + std::to_string( run->GetRunID() ) );
+        #endif
+    }
     G4cout << " ====================================================================== " << G4endl;
+
+    #ifdef ATLTileCalTB_FastSim
+    //Write the frozen showers collected from the workers
+    //
+    auto frozenShowerLibrary = ATLTileCalTBFrozenShowerLibrary::GetInstance();
+    if ( IsMaster() && frozenShowerLibrary->IsGenerating() ) frozenShowerLibrary->Write();
+    #endif
+}
+
+//HasOutputFile method
+//With per-thread files the master of a multi-thread run fills
+//nothing and writes no file, so that the run outputs can be chained
+//
+G4bool ATLTileCalTBRunAction::HasOutputFile() const {
+    #ifdef ATLTileCalTB_ThreadFiles
+    return !( IsMaster() && G4Threading::IsMultithreadedApplication() );
+    #else
+    return true;
+    #endif
+}
+
+//PrintThreadTimes method
+//The tail latency is the time the run waits for the last thread
+//after the average thread has finished
+//
+void ATLTileCalTBRunAction::PrintThreadTimes() const {
+    G4AutoLock lock(&threadTimesMutex);
+    if ( threadFinishTimes.empty() ) return;
+    auto events = std::minmax_element( threadFinishTimes.begin(), threadFinishTimes.end(),
+        [](const std::pair<G4int, G4double>& lhs, const std::pair<G4int, G4double>& rhs) { return lhs.first < rhs.first; } );
+    auto times = std::minmax_element( threadFinishTimes.begin(), threadFinishTimes.end(),
+        [](const std::pair<G4int, G4double>& lhs, const std::pair<G4int, G4double>& rhs) { return lhs.second < rhs.second; } );
+    G4double meanTime = 0.;
+    for ( const auto& thread : threadFinishTimes ) { meanTime += thread.second; }
+    meanTime /= static_cast<G4double>(threadFinishTimes.size());
+    G4cout << "  Threads: " << threadFinishTimes.size() << ", events per thread min/max: "
+           << events.first->first << "/" << events.second->first << G4endl;
+    G4cout << "  Thread finish time(s) first/mean/last: " << times.first->second << "/"
+           << meanTime << "/" << times.second->second << G4endl;
+    G4cout << "  Tail latency(s): " << times.second->second - meanTime << G4endl;
 }
 
 //**************************************************
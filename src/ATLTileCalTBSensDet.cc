@@ -11,6 +11,11 @@
 //
 #include "ATLTileCalTBSensDet.hh"
 #include "ATLTileCalTBConstants.hh"
+#include "ATLTileCalTBTimeBinning.hh"
+#ifdef ATLTileCalTB_FastSim
+#include "ATLTileCalTBFrozenShowerLibrary.hh"
+#include "ATLTileCalTBFrozenShowerRecorder.hh"
+#endif
 
 //Includers from Geant4
 //
@@ -21,12 +26,33 @@
 #include "G4ios.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Poisson.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#ifdef ATLTileCalTB_FastSim
+#include "G4FastHit.hh"
+#include "G4FastTrack.hh"
+#include "G4TouchableHistory.hh"
+#endif
+
+//Includers from C++
+//
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 //Constructor and de-constructor
 //
 ATLTileCalTBSensDet::ATLTileCalTBSensDet( const G4String& name, const G4String& hitsCollectionName )
     : G4VSensitiveDetector(name),
-      fHitsCollection(nullptr) {
+      fHitsCollection(nullptr)
+      #ifndef ATLTileCalTB_SparseHits
+      , fSignalBuffer(ATLTileCalTBGeometry::CellLUT::GetInstance()->GetNumberOfCells(),
+                      ATLTileCalTBTimeBinning::GetInstance()->GetNoOfBins())
+      #endif
+      #ifdef ATLTileCalTB_StepBuffer
+      , fStepBuffer(fStepBufferCapacity)
+      #endif
+      {
   
     collectionName.insert(hitsCollectionName);
 
@@ -50,9 +76,28 @@ void ATLTileCalTBSensDet::Initialize(G4HCofThisEvent* hce) {
     //Allocate hits in hit collection
     //
     auto cellLUT = ATLTileCalTBGeometry::CellLUT::GetInstance();
+    #ifdef ATLTileCalTB_SparseHits
     for ( std::size_t i=0; i<cellLUT->GetNumberOfCells(); i++ ) {
         fHitsCollection->insert(new ATLTileCalTBHit());
     }
+    #else
+    //Hits are views on the signal buffer, zeroed by the hits of the
+    //previous event (or copied if it is kept)
+    //
+    for ( std::size_t i=0; i<cellLUT->GetNumberOfCells(); i++ ) {
+        fHitsCollection->insert(new ATLTileCalTBHit(fSignalBuffer, i));
+    }
+    #endif
+
+    #ifdef ATLTileCalTB_StepBuffer
+    fStepBuffer.Clear();
+    #endif
+
+    #ifdef ATLTileCalTB_FastSim
+    if ( ATLTileCalTBFrozenShowerLibrary::GetInstance()->IsGenerating() ) {
+        ATLTileCalTBFrozenShowerRecorder::GetInstance()->Reset();
+    }
+    #endif
 
 }
 
@@ -76,17 +121,39 @@ G4bool ATLTileCalTBSensDet::ProcessHits( G4Step* aStep, G4TouchableHistory* ) {
     auto edep = aStep->GetTotalEnergyDeposit();
     if ( edep==0. ) return false; 
 
+    #ifdef ATLTileCalTB_FastSim
+    //Record the deposits of the frozen shower in generation mode
+    //
+    auto frozenShowerRecorder = ATLTileCalTBFrozenShowerRecorder::GetInstance();
+    if ( frozenShowerRecorder->IsStarted() ) {
+        frozenShowerRecorder->Record( aStep->GetPreStepPoint()->GetPosition(), BirkLaw( aStep ) );
+    }
+    #endif
+
+    #ifdef ATLTileCalTB_StepBuffer
+    //The response is computed later for all the buffered steps
+    //
+    BufferStep( aStep );
+    return true;
+    #else
+
     // we only record data within the time window of the digitization
     auto time = aStep->GetPreStepPoint()->GetGlobalTime();
-    if ( time > ATLTileCalTBConstants::frame_time_window ) return false;
+    auto frame = ATLTileCalTBTimeBinning::GetInstance()->GetBin( time );
+    if ( frame == SIZE_MAX ) return false;
 
-    auto cellLUT = ATLTileCalTBGeometry::CellLUT::GetInstance();
-    auto cellIndex = FindCellIndexFromG4( aStep );
-    auto cell = cellLUT->GetCell( cellIndex );
+    const auto& placement = FindPlacement( aStep->GetPreStepPoint()->GetTouchable() );
+    const auto cellIndex = placement.cellIndex;
     // Adjust energy according to Birk's Law
     G4double sdep = BirkLaw( aStep );
     // Convert energy to photoelectrons
+    #ifdef ATLTileCalTB_DeferredPoisson
+    // (expected value, photoelectrons are drawn per frame and U-shape
+    // response at the end of the event)
+    sdep *= ATLTileCalTBConstants::photoelectrons_per_energy;
+    #else
     sdep = static_cast<G4double>(G4Poisson(ATLTileCalTBConstants::photoelectrons_per_energy * sdep));
+    #endif
 
 
     //get local coordinates of PreStepPoint in scintillator
@@ -99,26 +166,93 @@ G4bool ATLTileCalTBSensDet::ProcessHits( G4Step* aStep, G4TouchableHistory* ) {
     
     //Apply U-shape and signal separation (up-down)
     //
-    G4double sdep_up = 0;
-    G4double sdep_down = 0;
-    G4int scintillator_copy_no = aStep->GetPreStepPoint()->GetTouchableHandle()->GetVolume(0)->GetCopyNo();
-    if (cell.module==ATLTileCalTBGeometry::Module::EXTENDED_C10 ){ 
-        //add 6 missing rows for cell C10
-        scintillator_copy_no += 6;
+    const auto uShapeResponse = Tile_1D_profileRescaled( placement.row, yLocal, zLocal, placement.uShape/*, 1*/ );
+
+    AddSignal( cellIndex, frame, edep, sdep, uShapeResponse );
+    return true;
+    #endif
+
+}
+
+#ifdef ATLTileCalTB_FastSim
+//ProcessHits base method for fast simulation
+//The energy of the hit is a frozen shower deposit in the scintillator,
+//which already includes Birks' law, or a parameterized shower spot
+//weighted by the model for the scintillator and Birks' law
+//
+G4bool ATLTileCalTBSensDet::ProcessHits( const G4FastHit* aHit, const G4FastTrack* aTrack, G4TouchableHistory* history ) {
+
+    auto edep = aHit->GetEnergy();
+    if ( edep==0. ) return false;
+
+    // the shower is deposited at the time of the replaced particle
+    auto time = aTrack->GetPrimaryTrack()->GetGlobalTime();
+    auto frame = ATLTileCalTBTimeBinning::GetInstance()->GetBin( time );
+    if ( frame == SIZE_MAX ) return false;
+
+    const auto& placement = FindPlacement( history );
+    // Convert energy to photoelectrons
+    #ifdef ATLTileCalTB_DeferredPoisson
+    G4double sdep = ATLTileCalTBConstants::photoelectrons_per_energy * edep;
+    #else
+    G4double sdep = static_cast<G4double>(G4Poisson(ATLTileCalTBConstants::photoelectrons_per_energy * edep));
+    #endif
+
+    //get local coordinates of the hit in scintillator
+    //
+    const G4ThreeVector localCoord = history->GetHistory()->GetTopTransform().TransformPoint(aHit->GetPosition());
+
+    //Apply U-shape and signal separation (up-down)
+    //
+    const auto uShapeResponse = Tile_1D_profileRescaled( placement.row, localCoord.y(), localCoord.z(), placement.uShape/*, 1*/ );
+    AddSignal( placement.cellIndex, frame, edep, sdep, uShapeResponse );
+    return true;
+
+}
+#endif
+
+//EndOfEvent base method
+//
+void ATLTileCalTBSensDet::EndOfEvent(G4HCofThisEvent*) {
+
+    #ifdef ATLTileCalTB_StepBuffer
+    ProcessSteps();
+    #endif
+
+    #ifdef ATLTileCalTB_FastSim
+    if ( ATLTileCalTBFrozenShowerLibrary::GetInstance()->IsGenerating() ) {
+        ATLTileCalTBFrozenShowerRecorder::GetInstance()->EndOfEvent();
     }
-    if ( cell.module==ATLTileCalTBGeometry::Module::EXTENDED_D4 ){
-        //add 9 missing rows for cell D4
-        scintillator_copy_no += 9;
+    #endif
+
+    #if defined(ATLTileCalTB_SparseHits) || defined(ATLTileCalTB_DeferredPoisson)
+    //One Poisson draw per frame and U-shape response with a signal,
+    //then one sparse entry per frame
+    //
+    for ( std::size_t i = 0; i < fHitsCollection->entries(); ++i ) {
+        auto hit = (*fHitsCollection)[i];
+        #ifdef ATLTileCalTB_DeferredPoisson
+        hit->SamplePhotoelectrons();
+        #endif
+        #ifdef ATLTileCalTB_SparseHits
+        if ( hit->IsActive() ) hit->Coalesce();
+        #endif
     }
-    sdep_up = sdep * Tile_1D_profileRescaled( scintillator_copy_no, yLocal, zLocal, 1, cell/*, 1*/ );
-    sdep_down = sdep * Tile_1D_profileRescaled( scintillator_copy_no, yLocal, zLocal, 0, cell/*, 1*/ );
+    #endif
+
+}
+
+//AddSignal method
+//
+void ATLTileCalTBSensDet::AddSignal( std::size_t cellIndex, std::size_t frame, G4double edep, G4double sdep,
+                                     const UShapeResponse& uShapeResponse ) {
 
     //Get corresponding hit
     //
     auto hit = (*fHitsCollection)[cellIndex];
     if ( ! hit ) {
         G4ExceptionDescription msg;
-        msg << "Cannot access hit from " << cell;
+        msg << "Cannot access hit from " << ATLTileCalTBGeometry::CellLUT::GetInstance()->GetCell(cellIndex);
         G4Exception("ATLTileCalTBSensDet::ProcessHits()",
         "MyCode0004", FatalException, msg);
     }         
@@ -126,17 +260,86 @@ G4bool ATLTileCalTBSensDet::ProcessHits( G4Step* aStep, G4TouchableHistory* ) {
     //Add hit energy 
     //
     hit->AddEdep(edep);
-    hit->AddSdep(time, sdep_up, sdep_down);
-    return true;
+    #ifdef ATLTileCalTB_DeferredPoisson
+    hit->AddExpectedPe(frame, sdep, uShapeResponse.up, uShapeResponse.down);
+    #else
+    hit->AddSdep(frame, sdep * uShapeResponse.up, sdep * uShapeResponse.down);
+    #endif
 
 }
 
-//EndOfEvent base method
+#ifdef ATLTileCalTB_StepBuffer
+//BufferStep method
+//Only the quantities that need the step and its touchable are taken here
 //
-void ATLTileCalTBSensDet::EndOfEvent(G4HCofThisEvent*) {
-    
+void ATLTileCalTBSensDet::BufferStep( const G4Step* aStep ) {
+
+    const auto preStepPoint = aStep->GetPreStepPoint();
+    const auto& placement = FindPlacement( aStep->GetPreStepPoint()->GetTouchable() );
+
+    //get local coordinates of PreStepPoint in scintillator
+    //
+    const G4ThreeVector localCoord =
+        preStepPoint->GetTouchableHandle()->GetHistory()->GetTopTransform().TransformPoint(preStepPoint->GetPosition());
+
+    fStepBuffer.Push( static_cast<std::uint32_t>(placement.cellIndex), static_cast<std::uint8_t>(placement.row),
+                      static_cast<std::uint8_t>(placement.uShape), localCoord.y(), localCoord.z(),
+                      preStepPoint->GetGlobalTime(), aStep->GetTotalEnergyDeposit(), aStep->GetTrack()->GetWeight(),
+                      aStep->GetStepLength(), preStepPoint->GetCharge(), preStepPoint->GetMaterial()->GetDensity() );
+
+    if ( fStepBuffer.IsFull() ) ProcessSteps();
+
 }
 
+//ProcessSteps method
+//Each stage runs over all the buffered steps, the photoelectrons are
+//drawn and the hits are updated in step order
+//
+void ATLTileCalTBSensDet::ProcessSteps() {
+
+    auto& steps = fStepBuffer;
+    const std::size_t n = steps.GetSize();
+    if ( n == 0 ) return;
+
+    //Time binning
+    //
+    const auto timeBinning = ATLTileCalTBTimeBinning::GetInstance();
+    for ( std::size_t i = 0; i < n; ++i ) {
+        steps.frame[i] = timeBinning->GetBin( steps.time[i] );
+    }
+
+    //Birks' law
+    //
+    BirkLaw( n, steps.edep.data(), steps.weight.data(), steps.length.data(), steps.charge.data(),
+             steps.density.data(), steps.sdep.data() );
+
+    //U-shape of the steps in the time window
+    //
+    for ( std::size_t i = 0; i < n; ++i ) {
+        if ( steps.frame[i] == SIZE_MAX ) continue;
+        const auto response = Tile_1D_profileRescaled( steps.row[i], steps.y[i], steps.z[i],
+                                                       static_cast<UShape>(steps.uShape[i])/*, 1*/ );
+        steps.up[i] = response.up;
+        steps.down[i] = response.down;
+    }
+
+    //Convert energy to photoelectrons and add the signals to the hits
+    //
+    for ( std::size_t i = 0; i < n; ++i ) {
+        if ( steps.frame[i] == SIZE_MAX ) continue;
+        #ifdef ATLTileCalTB_DeferredPoisson
+        const G4double sdep = steps.sdep[i] * ATLTileCalTBConstants::photoelectrons_per_energy;
+        #else
+        const G4double sdep = static_cast<G4double>(G4Poisson(ATLTileCalTBConstants::photoelectrons_per_energy * steps.sdep[i]));
+        #endif
+        AddSignal( steps.cell[i], steps.frame[i], steps.edep[i], sdep, {steps.up[i], steps.down[i]} );
+    }
+
+    steps.Clear();
+
+}
+#endif
+
 //BrikLaw method
 //This method is taken from the ATLAS Athena offline software
 //athena/TileCalorimeter/TileG4/TileGeoG4SD/src/TileGeoG4SDCalc.cc
@@ -183,36 +386,71 @@ G4double ATLTileCalTBSensDet::BirkLaw( const G4Step* aStep ) const {
 
 }
 
-// FindCellIndexFromG4 method
+#ifdef ATLTileCalTB_StepBuffer
+//BirkLaw method (buffered steps)
+//Same parametrization as above, written without branches: steps
+//with no charge or length get dedx = 0, i.e. no saturation, and a
+//step length that cannot trap in the (masked) division
 //
-std::size_t ATLTileCalTBSensDet::FindCellIndexFromG4( const G4Step* aStep ) const {
-    auto handle = aStep->GetPreStepPoint()->GetTouchableHandle();
+void ATLTileCalTBSensDet::BirkLaw( std::size_t n, const G4double* edep, const G4double* weight, const G4double* length,
+                                   const G4double* charge, const G4double* density, G4double* response ) {
+
+    const G4double rkb = 0.02002 * CLHEP::g / (CLHEP::MeV * CLHEP::cm2);      //m_birk1 in athena
+    const G4double m_birk2 = 0.0 * CLHEP::g / (CLHEP::MeV * CLHEP::cm2) * CLHEP::g / (CLHEP::MeV * CLHEP::cm2);
+    const G4double rkb_multicharge = rkb * (7.2 / 12.6);
+
+    for ( std::size_t i = 0; i < n; ++i ) {
+        const G4double destep = edep[i] * weight[i];
+        const G4double step_rkb = std::fabs(charge[i]) > 1.0 ? rkb_multicharge : rkb;
+        const G4double saturated = static_cast<G4double>(charge[i] != 0) * static_cast<G4double>(length[i] != 0);
+        const G4double step_length = length[i] + (1. - saturated);
+        const G4double dedx = saturated * (destep / step_length / density[i]);
+        response[i] = destep / (1. + step_rkb * dedx + m_birk2 * dedx * dedx);
+    }
 
-    // Get scintillator and period copy number, identical everywhere
-    G4int scintillator_copy_no = handle->GetVolume(0)->GetCopyNo();
-    G4int period_copy_no = handle->GetVolume(2)->GetCopyNo();
+}
+#endif
 
-    auto throwGeometryError = [&handle]() -> std::size_t {
+// MapScintillators method
+// The module is found from the names and copy numbers of the volumes
+// 5 levels above the scintillator, the period is 2 levels above it
+//
+void ATLTileCalTBSensDet::MapScintillators( const G4VPhysicalVolume* worldPV ) {
+    fModulePlacements.clear();
+    std::vector<const G4VPhysicalVolume*> path{ worldPV };
+    MapScintillators( path );
+}
+
+void ATLTileCalTBSensDet::MapScintillators( std::vector<const G4VPhysicalVolume*>& path ) {
+    auto logical = path.back()->GetLogicalVolume();
+    if ( logical->GetName() != "Tile::Scintillator" ) {
+        for ( std::size_t i = 0; i < logical->GetNoDaughters(); ++i ) {
+            path.push_back( logical->GetDaughter(i) );
+            MapScintillators( path );
+            path.pop_back();
+        }
+        return;
+    }
+
+    auto throwGeometryError = [&path]() {
         G4ExceptionDescription msg;
-        msg << "Fatal during geometry parsing:\n"
-            << handle->GetVolume(5)->GetName() << " [" << handle->GetVolume(5)->GetCopyNo() << "] "
-            << handle->GetVolume(4)->GetName() << " "
-            << handle->GetVolume(3)->GetName() << " "
-            << handle->GetVolume(2)->GetName() << " [" << handle->GetVolume(2)->GetCopyNo() << "] "
-            << handle->GetVolume(1)->GetName() << " "
-            << handle->GetVolume(0)->GetName() << " [" << handle->GetVolume(0)->GetCopyNo() << "] "
-            << G4endl;
-        G4Exception("ATLTileCalTBSensDet::FindCellIndexFromG4()",
+        msg << "Fatal during geometry parsing:\n";
+        for ( auto volume : path ) { msg << volume->GetName() << " [" << volume->GetCopyNo() << "] "; }
+        msg << G4endl;
+        G4Exception("ATLTileCalTBSensDet::MapScintillators()",
         "MyCode0005", FatalException, msg);
-        return SIZE_MAX; // Return impossible size
     };
+    if ( path.size() < 6 ) return throwGeometryError();
+
+    auto scintillatorPV = path[path.size() - 1];
+    auto periodPV = path[path.size() - 3];
+    auto modulePV = path[path.size() - 6];
 
     // Get module number via string, depends on module layout
     ATLTileCalTBGeometry::Module module;
-
-    auto module_name = handle->GetVolume(5)->GetName();
+    const auto& module_name = modulePV->GetName();
     if ( module_name == "Tile::BarrelModule" ) {
-        switch( handle->GetVolume(5)->GetCopyNo() ) {
+        switch( modulePV->GetCopyNo() ) {
             case 1:
                 module = ATLTileCalTBGeometry::Module::LONG_LOWER;
                 break;
@@ -237,198 +475,47 @@ std::size_t ATLTileCalTBSensDet::FindCellIndexFromG4( const G4Step* aStep ) cons
         return throwGeometryError();
     }
 
+    G4int scintillator_copy_no = scintillatorPV->GetCopyNo();
+    G4int period_copy_no = periodPV->GetCopyNo();
+    if ( scintillator_copy_no < 0 || scintillator_copy_no >= static_cast<G4int>(fNoOfRows) || period_copy_no < 0 ) {
+        return throwGeometryError();
+    }
+
     // Get index from CellLUT
     auto cellLUT = ATLTileCalTBGeometry::CellLUT::GetInstance();
-    auto index = cellLUT->FindCellIndex(module, scintillator_copy_no, period_copy_no);
-
-    return index;
-
-}
-
-//Tile_1D_profileRescaled method
-//This method is adapted from the ATLAS athena offline software
-//athena/TileCalorimeter/TileG4/TileGeoG4SD/src/TileGeoG4SDCalc.cc
-//as on June 2022.
-//
-G4double ATLTileCalTBSensDet::Tile_1D_profileRescaled( G4int row, G4double x, G4double y, G4int PMT, ATLTileCalTBGeometry::Cell cell/*, G4int nSide*/ ){
-
-    if (PMT) x *= -1.;
-
-    const double xlow = -0.0495; //dPhi low [rad]
-    const double xup = 0.0495; //dPhi up [rad]
-    const double range = (xup - xlow); //dPhi range
-    const int size = 99;
-
-    const G4double LB_A_TilePMT[size] = { 0.797741, 0.767611, 0.737482, 0.731121, 0.715537, 0.689929, 0.690055, 0.687185,
-                                        0.685124, 0.673707, 0.664842, 0.663197, 0.660089, 0.647501, 0.650303, 0.644465,
-                                        0.639813, 0.631315, 0.627008, 0.622707, 0.614297, 0.61109, 0.604147, 0.605184,
-                                        0.603651, 0.592072, 0.588977, 0.585351, 0.588941, 0.578247, 0.580187, 0.576195,
-                                        0.576942, 0.57606, 0.570978, 0.568398, 0.563464, 0.565646, 0.557544, 0.56112,
-                                        0.552727, 0.556008, 0.555573, 0.554079, 0.548542, 0.551241, 0.538841, 0.523046,
-                                        0.501209, 0.474613, 0.46968, 0.465796, 0.465135, 0.466067, 0.456968, 0.458314,
-                                        0.454288, 0.450544, 0.445219, 0.444452, 0.437612, 0.440608, 0.432754, 0.432117,
-                                        0.429496, 0.427993, 0.42394, 0.419026, 0.41752, 0.412359, 0.416317, 0.408531,
-                                        0.40574, 0.405237, 0.407231, 0.403318, 0.398811, 0.39869, 0.396117, 0.396753,
-                                        0.395918, 0.393898, 0.39377, 0.390499, 0.390835, 0.38526, 0.385113, 0.383958,
-                                        0.37829, 0.375895, 0.375872, 0.370231, 0.364742, 0.353429, 0.349633, 0.333518,
-                                        0.305173, 0.287103, 0.269032 };
-
-    const G4double LB_BC_TilePMT[size] = { 0.83904, 0.781078, 0.723117, 0.708466, 0.691473, 0.680283, 0.673512, 0.668259,
-                                         0.663925, 0.661599, 0.66064, 0.645793, 0.638767, 0.638648, 0.633753, 0.632288,
-                                         0.62912, 0.621557, 0.610724, 0.611454, 0.608478, 0.598683, 0.599413, 0.59475,
-                                         0.591156, 0.585141, 0.58734, 0.582087, 0.581133, 0.577544, 0.565483, 0.565771,
-                                         0.566045, 0.562009, 0.558788, 0.554103, 0.554569, 0.552122, 0.55021, 0.544131,
-                                         0.546458, 0.545739, 0.542813, 0.539188, 0.539949, 0.531312, 0.529154, 0.511045,
-                                         0.50547, 0.485915, 0.483028, 0.469858, 0.475142, 0.468828, 0.471476, 0.466037,
-                                         0.462818, 0.460826, 0.456697, 0.450356, 0.451149, 0.447394, 0.444391, 0.440424,
-                                         0.437831, 0.436551, 0.433858, 0.429664, 0.424668, 0.429436, 0.426802, 0.422796,
-                                         0.423084, 0.416585, 0.416778, 0.413823, 0.413039, 0.407278, 0.409132, 0.405958,
-                                         0.400924, 0.40319, 0.402826, 0.400298, 0.39617, 0.393594, 0.388368, 0.387257,
-                                         0.390185, 0.383722, 0.377989, 0.373987, 0.368134, 0.36161, 0.353643, 0.340893,
-                                         0.31819, 0.31064, 0.30309 };
-
-    const G4double LB_D_TilePMT[size] = { 0.795522, 0.77882, 0.762117, 0.758668, 0.739907, 0.738439, 0.725206, 0.705747,
-                                        0.694305, 0.679948, 0.661304, 0.646417, 0.646898, 0.643, 0.64742, 0.642599,
-                                        0.644594, 0.630441, 0.62819, 0.633067, 0.620992, 0.615444, 0.614593, 0.605262,
-                                        0.600121, 0.593196, 0.598287, 0.594506, 0.587352, 0.586836, 0.584799, 0.565766,
-                                        0.573146, 0.555629, 0.556809, 0.554736, 0.548224, 0.548666, 0.547577, 0.547152,
-                                        0.548186, 0.541246, 0.534641, 0.535219, 0.527666, 0.526342, 0.519253, 0.514271,
-                                        0.497834, 0.486737, 0.478467, 0.476815, 0.470943, 0.470212, 0.465885, 0.463963,
-                                        0.457575, 0.456578, 0.457046, 0.45066, 0.446101, 0.442831, 0.437027, 0.435233,
-                                        0.431566, 0.423259, 0.432401, 0.419528, 0.426179, 0.421962, 0.415978, 0.416232,
-                                        0.416315, 0.406703, 0.406586, 0.405589, 0.405727, 0.400639, 0.397638, 0.399703,
-                                        0.389905, 0.38658, 0.388681, 0.381943, 0.380274, 0.371921, 0.367581, 0.359151,
-                                        0.360523, 0.359632, 0.35602, 0.351288, 0.350362, 0.348065, 0.341942, 0.337538,
-                                        0.323205, 0.306686, 0.290166 };
-
-    /*const G4double EBA_A_TilePMT[size] = { 0.785637, 0.764265, 0.742893, 0.7265, 0.705835, 0.701582, 0.694623, 0.67782,
-                                         0.679425, 0.672377, 0.677163, 0.66816, 0.667518, 0.64911, 0.648474, 0.65169,
-                                         0.633917, 0.636953, 0.640227, 0.623941, 0.620663, 0.608101, 0.609174, 0.599297,
-                                         0.601839, 0.600618, 0.591399, 0.588176, 0.589987, 0.584444, 0.580839, 0.578097,
-                                         0.572712, 0.578424, 0.563277, 0.564594, 0.567886, 0.559251, 0.559901, 0.555709,
-                                         0.544783, 0.548855, 0.54916, 0.545375, 0.554854, 0.538948, 0.536859, 0.516408,
-                                         0.497057, 0.478121, 0.468015, 0.461105, 0.463244, 0.457987, 0.463463, 0.450963,
-                                         0.452678, 0.447139, 0.439209, 0.444305, 0.442167, 0.434897, 0.436045, 0.432974,
-                                         0.422726, 0.431913, 0.424147, 0.420568, 0.420822, 0.417563, 0.416604, 0.410264,
-                                         0.408909, 0.408875, 0.406464, 0.399841, 0.402915, 0.399772, 0.399093, 0.398666,
-                                         0.403387, 0.393809, 0.390633, 0.396707, 0.387452, 0.383384, 0.38485, 0.384494,
-                                         0.385934, 0.374029, 0.368439, 0.363214, 0.365663, 0.35614, 0.350155, 0.333629,
-                                         0.315841, 0.293913, 0.271986 };
-
-    const G4double EBA_BC_TilePMT[size] = { 0.76425, 0.741305, 0.718361, 0.702739, 0.689698, 0.673952, 0.66942, 0.668102,
-                                          0.659098, 0.659453, 0.659288, 0.651001, 0.644689, 0.642691, 0.639191,
-                                          0.631008, 0.634213, 0.624853, 0.611546, 0.616879, 0.614165, 0.603962,
-                                          0.596658, 0.597363, 0.583505, 0.588016, 0.584818, 0.580456, 0.576679,
-                                          0.570277, 0.569343, 0.572166, 0.564008, 0.564188, 0.556544, 0.559867,
-                                          0.557225, 0.551476, 0.548382, 0.544258, 0.543926, 0.540005, 0.538831,
-                                          0.543222, 0.53448, 0.535014, 0.528731, 0.517457, 0.501963, 0.489472, 0.480086,
-                                          0.47594, 0.474252, 0.471684, 0.467381, 0.47002, 0.462449, 0.458279, 0.45573,
-                                          0.45085, 0.451388, 0.448358, 0.448926, 0.446427, 0.437154, 0.439613, 0.434813,
-                                          0.435781, 0.430242, 0.426984, 0.426776, 0.424525, 0.422673, 0.420809,
-                                          0.415454, 0.418039, 0.412673, 0.412611, 0.41453, 0.413378, 0.402649, 0.408683,
-                                          0.407647, 0.403596, 0.401837, 0.397678, 0.395147, 0.392898, 0.391702,
-                                          0.386557, 0.377788, 0.37777, 0.37069, 0.364217, 0.360065, 0.348944, 0.330525,
-                                          0.308675, 0.286825 };
-
-    const G4double EBA_D_TilePMT[size] = { 0.83964, 0.797377, 0.755114, 0.758831, 0.750956, 0.727028, 0.710895, 0.7013,
-                                         0.696957, 0.678444, 0.675153, 0.659896, 0.656481, 0.6555, 0.648582, 0.64414,
-                                         0.634209, 0.63669, 0.630879, 0.626185, 0.610719, 0.616651, 0.608967, 0.597805,
-                                         0.601157, 0.599113, 0.589518, 0.581218, 0.582136, 0.577285, 0.576426, 0.566552,
-                                         0.565228, 0.554291, 0.552419, 0.555652, 0.545789, 0.54289, 0.537612, 0.537218,
-                                         0.539621, 0.528208, 0.529998, 0.530758, 0.532108, 0.522749, 0.511517, 0.51012,
-                                         0.499114, 0.490116, 0.480166, 0.474294, 0.463783, 0.464397, 0.467149, 0.460705,
-                                         0.452137, 0.446681, 0.449894, 0.44324, 0.438109, 0.437593, 0.433048, 0.437898,
-                                         0.429795, 0.425461, 0.428106, 0.42259, 0.42333, 0.417693, 0.416418, 0.413091,
-                                         0.412467, 0.415014, 0.408279, 0.402152, 0.406765, 0.403563, 0.395906, 0.399396,
-                                         0.396097, 0.395945, 0.387978, 0.389495, 0.386988, 0.382293, 0.374119, 0.367898,
-                                         0.366629, 0.359724, 0.358971, 0.353465, 0.352667, 0.348716, 0.352001, 0.340563,
-                                         0.319873, 0.320009, 0.320145 };*/
-
-    const G4double EBC_A_TilePMT[size] = { 0.765353, 0.744828, 0.724302, 0.711989, 0.695914, 0.704155, 0.693387, 0.676819,
-                                         0.676799, 0.668149, 0.678667, 0.668981, 0.662106, 0.648292, 0.646541, 0.650966,
-                                         0.634939, 0.629944, 0.638864, 0.624766, 0.619045, 0.609469, 0.610016, 0.604568,
-                                         0.602381, 0.60177, 0.594209, 0.586193, 0.587409, 0.588692, 0.586485, 0.58167,
-                                         0.573177, 0.572706, 0.565486, 0.569903, 0.565703, 0.562678, 0.561827, 0.555701,
-                                         0.5488, 0.54492, 0.552272, 0.5472, 0.553907, 0.538975, 0.532071, 0.512574,
-                                         0.501337, 0.486138, 0.474234, 0.465142, 0.467719, 0.46093, 0.464721, 0.453282,
-                                         0.451003, 0.44518, 0.440071, 0.442123, 0.441155, 0.437047, 0.435727, 0.432586,
-                                         0.425206, 0.427655, 0.422533, 0.424865, 0.422092, 0.420273, 0.415346, 0.409133,
-                                         0.414508, 0.410388, 0.404746, 0.403885, 0.398622, 0.398415, 0.398836, 0.401538,
-                                         0.403333, 0.393603, 0.391392, 0.395468, 0.388086, 0.381737, 0.38563, 0.38291,
-                                         0.385134, 0.373556, 0.368796, 0.365477, 0.361356, 0.356366, 0.337974, 0.327807,
-                                         0.321853, 0.316427, 0.311002 };
-
-    const G4double EBC_BC_TilePMT[size] = { 0.7648, 0.737577, 0.710355, 0.692604, 0.686204, 0.679879, 0.671754, 0.665405,
-                                          0.661076, 0.659704, 0.658373, 0.650191, 0.643016, 0.636251, 0.636981,
-                                          0.631083, 0.629664, 0.624073, 0.611652, 0.616094, 0.610218, 0.605689,
-                                          0.599631, 0.598852, 0.58564, 0.582424, 0.587247, 0.579566, 0.573991, 0.574983,
-                                          0.569965, 0.57214, 0.565687, 0.565212, 0.553511, 0.556306, 0.55677, 0.550087,
-                                          0.548716, 0.543633, 0.543634, 0.540209, 0.538204, 0.541047, 0.539491,
-                                          0.531351, 0.52245, 0.512828, 0.504501, 0.491639, 0.484139, 0.475865, 0.47199,
-                                          0.471604, 0.469904, 0.467587, 0.4615, 0.457367, 0.45596, 0.4502, 0.44924,
-                                          0.44714, 0.448449, 0.44337, 0.436506, 0.441099, 0.433849, 0.437988, 0.432466,
-                                          0.429481, 0.425351, 0.424773, 0.424019, 0.41792, 0.414599, 0.41823, 0.415068,
-                                          0.4173, 0.412434, 0.413478, 0.403198, 0.409181, 0.40829, 0.404226, 0.402178,
-                                          0.394833, 0.393679, 0.393674, 0.391172, 0.387596, 0.379518, 0.376184,
-                                          0.373049, 0.365151, 0.355832, 0.343082, 0.33591, 0.325943, 0.315977 };
-
-    const G4double EBC_D_TilePMT[size] = { 0.810214, 0.783731, 0.757247, 0.765208, 0.759164, 0.741329, 0.728715, 0.705468,
-                                         0.696755, 0.676816, 0.667219, 0.654211, 0.652711, 0.65308, 0.645492, 0.648598,
-                                         0.639812, 0.639477, 0.635602, 0.62643, 0.610883, 0.617949, 0.607085, 0.602215,
-                                         0.598796, 0.598681, 0.591363, 0.587693, 0.580236, 0.579129, 0.578721, 0.569181,
-                                         0.571318, 0.55844, 0.555816, 0.557064, 0.547434, 0.546389, 0.543078, 0.539943,
-                                         0.53965, 0.533382, 0.530646, 0.531389, 0.531807, 0.523653, 0.513609, 0.514248,
-                                         0.501599, 0.491929, 0.483775, 0.481274, 0.4627, 0.464578, 0.465772, 0.460731,
-                                         0.453232, 0.448857, 0.44975, 0.444581, 0.441382, 0.437043, 0.436079, 0.437289,
-                                         0.431411, 0.425935, 0.430075, 0.422739, 0.422647, 0.415665, 0.412222, 0.411782,
-                                         0.409388, 0.410704, 0.405253, 0.402566, 0.398764, 0.402502, 0.392514, 0.396349,
-                                         0.396642, 0.391042, 0.389076, 0.387543, 0.377968, 0.379668, 0.375101, 0.366595,
-                                         0.367618, 0.360109, 0.359919, 0.350608, 0.353021, 0.348171, 0.345853, 0.337198,
-                                         0.319714, 0.311871, 0.304028 };
-  
-    //Array of tiles distances from center in the ATLAS Experiment (from athena). 
-    //In the simulation the beam position should be 2298 0 0 mm to get the same distances
-    //
-    const double R[11] = { 2350., 2450., 2550., 2680., 2810., 2940., 3090., 3240., 3390., 3580., 3770. };
+    Placement placement;
+    placement.cellIndex = cellLUT->FindCellIndex(module, scintillator_copy_no, period_copy_no);
+    auto cell = cellLUT->GetCell(placement.cellIndex);
 
-    const double sizerange = (double) size / range;
-    const double size2 = (double) size / 2.;
-
-    if (row < 0 || row >= 11) {
-        G4cout<<"-->ERROR in tile row"<<G4endl;
-        return 0.;
+    placement.row = scintillator_copy_no;
+    if ( module == ATLTileCalTBGeometry::Module::EXTENDED_C10 ) {
+        //add 6 missing rows for cell C10
+        placement.row += 6;
     }
-    const double phi = atan(x / (y + R[row]));
-    const int index = int(phi * sizerange + size2);
-
-    if (index < 0 || index >= size) {
-        G4cout<<"-->ERROR in U-shape index"<<G4endl;
-        return 0.;
+    if ( module == ATLTileCalTBGeometry::Module::EXTENDED_D4 ) {
+        //add 9 missing rows for cell D4
+        placement.row += 9;
     }
 
-    auto throwCellLogicError = [&cell]() -> G4double {
+    auto throwCellLogicError = [&cell]() {
         G4ExceptionDescription msg;
         msg << "Given cell does not make sense:\n"
             << cell << G4endl;
-        G4Exception("ATLTileCalTBSensDet::Tile_1D_profileRescaled",
+        G4Exception("ATLTileCalTBSensDet::MapScintillators()",
         "MyCode0006", FatalException, msg);
-        return 0.;
     };
-
-    G4double amplitude = 0.0;
-
     switch (cell.module) {
         case ATLTileCalTBGeometry::Module::LONG_LOWER:
         case ATLTileCalTBGeometry::Module::LONG_UPPER:
             switch (cell.row) {
                 case ATLTileCalTBGeometry::Row::A:
-                    amplitude = LB_A_TilePMT[index];
+                    placement.uShape = UShape::LB_A;
                     break;
                 case ATLTileCalTBGeometry::Row::BC:
-                    amplitude = LB_BC_TilePMT[index];
+                    placement.uShape = UShape::LB_BC;
                     break;
                 case ATLTileCalTBGeometry::Row::D:
-                    amplitude = LB_D_TilePMT[index];
+                    placement.uShape = UShape::LB_D;
                     break;
                 default:
                     return throwCellLogicError();
@@ -437,29 +524,16 @@ G4double ATLTileCalTBSensDet::Tile_1D_profileRescaled( G4int row, G4double x, G4
         case ATLTileCalTBGeometry::Module::EXTENDED:
         case ATLTileCalTBGeometry::Module::EXTENDED_C10:
         case ATLTileCalTBGeometry::Module::EXTENDED_D4:
-            /*
-            //if (nSide > 0) {     //at TB EBC was used
-            if (row < 3) {         //A layer
-                amplitude = EBA_A_TilePMT[index];
-            }
-            else if (row < 7) {    //BC layer
-                amplitude = EBA_BC_TilePMT[index];
-            }
-            else {                 //D layer
-                amplitude = EBA_D_TilePMT[index];
-            }
-            //}
-            */
             switch (cell.row) {
                 case ATLTileCalTBGeometry::Row::A:
-                    amplitude = EBC_A_TilePMT[index];
+                    placement.uShape = UShape::EB_A;
                     break;
                 case ATLTileCalTBGeometry::Row::B:
                 case ATLTileCalTBGeometry::Row::C:
-                    amplitude = EBC_BC_TilePMT[index];
+                    placement.uShape = UShape::EB_BC;
                     break;
                 case ATLTileCalTBGeometry::Row::D:
-                    amplitude = EBC_D_TilePMT[index];
+                    placement.uShape = UShape::EB_D;
                     break;
                 default:
                     return throwCellLogicError();
@@ -467,8 +541,284 @@ G4double ATLTileCalTBSensDet::Tile_1D_profileRescaled( G4int row, G4double x, G4
             break;
     }
 
-  //G4cout<<amplitude<<G4endl;
-  return amplitude;
+    // Store in the table of the module
+    auto modulePlacements = std::find_if(fModulePlacements.begin(), fModulePlacements.end(),
+        [modulePV](const ModulePlacements& placements){ return placements.modulePV == modulePV; });
+    if ( modulePlacements == fModulePlacements.end() ) {
+        fModulePlacements.push_back({modulePV, {}});
+        modulePlacements = fModulePlacements.end() - 1;
+    }
+    if ( modulePlacements->periods.size() <= static_cast<std::size_t>(period_copy_no) ) {
+        modulePlacements->periods.resize(period_copy_no + 1);
+    }
+    modulePlacements->periods[period_copy_no][scintillator_copy_no] = placement;
+}
+
+// FindPlacement method
+// Module volumes are compared by address, period and scintillator
+// copy numbers index the table of the module
+//
+const ATLTileCalTBSensDet::Placement& ATLTileCalTBSensDet::FindPlacement( const G4VTouchable* touchable ) const {
+    auto modulePV = touchable->GetVolume(5);
+
+    for ( const auto& modulePlacements : fModulePlacements ) {
+        if ( modulePlacements.modulePV != modulePV ) continue;
+        auto period_copy_no = static_cast<std::size_t>(touchable->GetVolume(2)->GetCopyNo());
+        auto scintillator_copy_no = static_cast<std::size_t>(touchable->GetVolume(0)->GetCopyNo());
+        if ( period_copy_no < modulePlacements.periods.size() && scintillator_copy_no < fNoOfRows ) {
+            const auto& placement = modulePlacements.periods[period_copy_no][scintillator_copy_no];
+            if ( placement.cellIndex != SIZE_MAX ) return placement;
+        }
+        break;
+    }
+
+    G4ExceptionDescription msg;
+    msg << "Scintillator placement not mapped:\n";
+    for ( G4int depth = 5; depth >= 0; --depth ) {
+        msg << touchable->GetVolume(depth)->GetName() << " [" << touchable->GetVolume(depth)->GetCopyNo() << "] ";
+    }
+    msg << G4endl;
+    G4Exception("ATLTileCalTBSensDet::FindPlacement()",
+    "MyCode0005", FatalException, msg);
+    static const Placement invalid;
+    return invalid; // Return impossible placement
+}
+
+//U-shape profiles adapted from the ATLAS athena offline software
+//athena/TileCalorimeter/TileG4/TileGeoG4SD/src/TileGeoG4SDCalc.cc
+//as on June 2022. Response of a PMT as a function of dPhi, binned in
+//uShapeBins bins in [-uShapeHalfRange, uShapeHalfRange] [rad] and
+//indexed by UShape. At the TB the EBC profiles were used for the
+//extended barrel, the EBA ones are kept below for reference.
+//
+constexpr std::size_t uShapeBins = 99;
+constexpr G4double uShapeHalfRange = 0.0495;
+constexpr G4double uShapeBinsPerRad = (G4double) uShapeBins / (2. * uShapeHalfRange);
+constexpr G4double uShapeHalfBins = (G4double) uShapeBins / 2.;
+
+static constexpr G4double uShapeProfiles[6][uShapeBins] = {
+    // LB_A
+    {
+        0.797741, 0.767611, 0.737482, 0.731121, 0.715537, 0.689929, 0.690055, 0.687185,
+        0.685124, 0.673707, 0.664842, 0.663197, 0.660089, 0.647501, 0.650303, 0.644465,
+        0.639813, 0.631315, 0.627008, 0.622707, 0.614297, 0.61109, 0.604147, 0.605184,
+        0.603651, 0.592072, 0.588977, 0.585351, 0.588941, 0.578247, 0.580187, 0.576195,
+        0.576942, 0.57606, 0.570978, 0.568398, 0.563464, 0.565646, 0.557544, 0.56112,
+        0.552727, 0.556008, 0.555573, 0.554079, 0.548542, 0.551241, 0.538841, 0.523046,
+        0.501209, 0.474613, 0.46968, 0.465796, 0.465135, 0.466067, 0.456968, 0.458314,
+        0.454288, 0.450544, 0.445219, 0.444452, 0.437612, 0.440608, 0.432754, 0.432117,
+        0.429496, 0.427993, 0.42394, 0.419026, 0.41752, 0.412359, 0.416317, 0.408531,
+        0.40574, 0.405237, 0.407231, 0.403318, 0.398811, 0.39869, 0.396117, 0.396753,
+        0.395918, 0.393898, 0.39377, 0.390499, 0.390835, 0.38526, 0.385113, 0.383958,
+        0.37829, 0.375895, 0.375872, 0.370231, 0.364742, 0.353429, 0.349633, 0.333518,
+        0.305173, 0.287103, 0.269032
+    },
+    // LB_BC
+    {
+        0.83904, 0.781078, 0.723117, 0.708466, 0.691473, 0.680283, 0.673512, 0.668259,
+        0.663925, 0.661599, 0.66064, 0.645793, 0.638767, 0.638648, 0.633753, 0.632288,
+        0.62912, 0.621557, 0.610724, 0.611454, 0.608478, 0.598683, 0.599413, 0.59475,
+        0.591156, 0.585141, 0.58734, 0.582087, 0.581133, 0.577544, 0.565483, 0.565771,
+        0.566045, 0.562009, 0.558788, 0.554103, 0.554569, 0.552122, 0.55021, 0.544131,
+        0.546458, 0.545739, 0.542813, 0.539188, 0.539949, 0.531312, 0.529154, 0.511045,
+        0.50547, 0.485915, 0.483028, 0.469858, 0.475142, 0.468828, 0.471476, 0.466037,
+        0.462818, 0.460826, 0.456697, 0.450356, 0.451149, 0.447394, 0.444391, 0.440424,
+        0.437831, 0.436551, 0.433858, 0.429664, 0.424668, 0.429436, 0.426802, 0.422796,
+        0.423084, 0.416585, 0.416778, 0.413823, 0.413039, 0.407278, 0.409132, 0.405958,
+        0.400924, 0.40319, 0.402826, 0.400298, 0.39617, 0.393594, 0.388368, 0.387257,
+        0.390185, 0.383722, 0.377989, 0.373987, 0.368134, 0.36161, 0.353643, 0.340893,
+        0.31819, 0.31064, 0.30309
+    },
+    // LB_D
+    {
+        0.795522, 0.77882, 0.762117, 0.758668, 0.739907, 0.738439, 0.725206, 0.705747,
+        0.694305, 0.679948, 0.661304, 0.646417, 0.646898, 0.643, 0.64742, 0.642599,
+        0.644594, 0.630441, 0.62819, 0.633067, 0.620992, 0.615444, 0.614593, 0.605262,
+        0.600121, 0.593196, 0.598287, 0.594506, 0.587352, 0.586836, 0.584799, 0.565766,
+        0.573146, 0.555629, 0.556809, 0.554736, 0.548224, 0.548666, 0.547577, 0.547152,
+        0.548186, 0.541246, 0.534641, 0.535219, 0.527666, 0.526342, 0.519253, 0.514271,
+        0.497834, 0.486737, 0.478467, 0.476815, 0.470943, 0.470212, 0.465885, 0.463963,
+        0.457575, 0.456578, 0.457046, 0.45066, 0.446101, 0.442831, 0.437027, 0.435233,
+        0.431566, 0.423259, 0.432401, 0.419528, 0.426179, 0.421962, 0.415978, 0.416232,
+        0.416315, 0.406703, 0.406586, 0.405589, 0.405727, 0.400639, 0.397638, 0.399703,
+        0.389905, 0.38658, 0.388681, 0.381943, 0.380274, 0.371921, 0.367581, 0.359151,
+        0.360523, 0.359632, 0.35602, 0.351288, 0.350362, 0.348065, 0.341942, 0.337538,
+        0.323205, 0.306686, 0.290166
+    },
+    // EB_A
+    {
+        0.765353, 0.744828, 0.724302, 0.711989, 0.695914, 0.704155, 0.693387, 0.676819,
+        0.676799, 0.668149, 0.678667, 0.668981, 0.662106, 0.648292, 0.646541, 0.650966,
+        0.634939, 0.629944, 0.638864, 0.624766, 0.619045, 0.609469, 0.610016, 0.604568,
+        0.602381, 0.60177, 0.594209, 0.586193, 0.587409, 0.588692, 0.586485, 0.58167,
+        0.573177, 0.572706, 0.565486, 0.569903, 0.565703, 0.562678, 0.561827, 0.555701,
+        0.5488, 0.54492, 0.552272, 0.5472, 0.553907, 0.538975, 0.532071, 0.512574,
+        0.501337, 0.486138, 0.474234, 0.465142, 0.467719, 0.46093, 0.464721, 0.453282,
+        0.451003, 0.44518, 0.440071, 0.442123, 0.441155, 0.437047, 0.435727, 0.432586,
+        0.425206, 0.427655, 0.422533, 0.424865, 0.422092, 0.420273, 0.415346, 0.409133,
+        0.414508, 0.410388, 0.404746, 0.403885, 0.398622, 0.398415, 0.398836, 0.401538,
+        0.403333, 0.393603, 0.391392, 0.395468, 0.388086, 0.381737, 0.38563, 0.38291,
+        0.385134, 0.373556, 0.368796, 0.365477, 0.361356, 0.356366, 0.337974, 0.327807,
+        0.321853, 0.316427, 0.311002
+    },
+    // EB_BC
+    {
+        0.7648, 0.737577, 0.710355, 0.692604, 0.686204, 0.679879, 0.671754, 0.665405,
+        0.661076, 0.659704, 0.658373, 0.650191, 0.643016, 0.636251, 0.636981, 0.631083,
+        0.629664, 0.624073, 0.611652, 0.616094, 0.610218, 0.605689, 0.599631, 0.598852,
+        0.58564, 0.582424, 0.587247, 0.579566, 0.573991, 0.574983, 0.569965, 0.57214,
+        0.565687, 0.565212, 0.553511, 0.556306, 0.55677, 0.550087, 0.548716, 0.543633,
+        0.543634, 0.540209, 0.538204, 0.541047, 0.539491, 0.531351, 0.52245, 0.512828,
+        0.504501, 0.491639, 0.484139, 0.475865, 0.47199, 0.471604, 0.469904, 0.467587,
+        0.4615, 0.457367, 0.45596, 0.4502, 0.44924, 0.44714, 0.448449, 0.44337,
+        0.436506, 0.441099, 0.433849, 0.437988, 0.432466, 0.429481, 0.425351, 0.424773,
+        0.424019, 0.41792, 0.414599, 0.41823, 0.415068, 0.4173, 0.412434, 0.413478,
+        0.403198, 0.409181, 0.40829, 0.404226, 0.402178, 0.394833, 0.393679, 0.393674,
+        0.391172, 0.387596, 0.379518, 0.376184, 0.373049, 0.365151, 0.355832, 0.343082,
+        0.33591, 0.325943, 0.315977
+    },
+    // EB_D
+    {
+        0.810214, 0.783731, 0.757247, 0.765208, 0.759164, 0.741329, 0.728715, 0.705468,
+        0.696755, 0.676816, 0.667219, 0.654211, 0.652711, 0.65308, 0.645492, 0.648598,
+        0.639812, 0.639477, 0.635602, 0.62643, 0.610883, 0.617949, 0.607085, 0.602215,
+        0.598796, 0.598681, 0.591363, 0.587693, 0.580236, 0.579129, 0.578721, 0.569181,
+        0.571318, 0.55844, 0.555816, 0.557064, 0.547434, 0.546389, 0.543078, 0.539943,
+        0.53965, 0.533382, 0.530646, 0.531389, 0.531807, 0.523653, 0.513609, 0.514248,
+        0.501599, 0.491929, 0.483775, 0.481274, 0.4627, 0.464578, 0.465772, 0.460731,
+        0.453232, 0.448857, 0.44975, 0.444581, 0.441382, 0.437043, 0.436079, 0.437289,
+        0.431411, 0.425935, 0.430075, 0.422739, 0.422647, 0.415665, 0.412222, 0.411782,
+        0.409388, 0.410704, 0.405253, 0.402566, 0.398764, 0.402502, 0.392514, 0.396349,
+        0.396642, 0.391042, 0.389076, 0.387543, 0.377968, 0.379668, 0.375101, 0.366595,
+        0.367618, 0.360109, 0.359919, 0.350608, 0.353021, 0.348171, 0.345853, 0.337198,
+        0.319714, 0.311871, 0.304028
+    }
+};
+
+/*const G4double EBA_A_TilePMT[size] = { 0.785637, 0.764265, 0.742893, 0.7265, 0.705835, 0.701582, 0.694623, 0.67782,
+                                     0.679425, 0.672377, 0.677163, 0.66816, 0.667518, 0.64911, 0.648474, 0.65169,
+                                     0.633917, 0.636953, 0.640227, 0.623941, 0.620663, 0.608101, 0.609174, 0.599297,
+                                     0.601839, 0.600618, 0.591399, 0.588176, 0.589987, 0.584444, 0.580839, 0.578097,
+                                     0.572712, 0.578424, 0.563277, 0.564594, 0.567886, 0.559251, 0.559901, 0.555709,
+                                     0.544783, 0.548855, 0.54916, 0.545375, 0.554854, 0.538948, 0.536859, 0.516408,
+                                     0.497057, 0.478121, 0.468015, 0.461105, 0.463244, 0.457987, 0.463463, 0.450963,
+                                     0.452678, 0.447139, 0.439209, 0.444305, 0.442167, 0.434897, 0.436045, 0.432974,
+                                     0.422726, 0.431913, 0.424147, 0.420568, 0.420822, 0.417563, 0.416604, 0.410264,
+                                     0.408909, 0.408875, 0.406464, 0.399841, 0.402915, 0.399772, 0.399093, 0.398666,
+                                     0.403387, 0.393809, 0.390633, 0.396707, 0.387452, 0.383384, 0.38485, 0.384494,
+                                     0.385934, 0.374029, 0.368439, 0.363214, 0.365663, 0.35614, 0.350155, 0.333629,
+                                     0.315841, 0.293913, 0.271986 };
+
+const G4double EBA_BC_TilePMT[size] = { 0.76425, 0.741305, 0.718361, 0.702739, 0.689698, 0.673952, 0.66942, 0.668102,
+                                      0.659098, 0.659453, 0.659288, 0.651001, 0.644689, 0.642691, 0.639191,
+                                      0.631008, 0.634213, 0.624853, 0.611546, 0.616879, 0.614165, 0.603962,
+                                      0.596658, 0.597363, 0.583505, 0.588016, 0.584818, 0.580456, 0.576679,
+                                      0.570277, 0.569343, 0.572166, 0.564008, 0.564188, 0.556544, 0.559867,
+                                      0.557225, 0.551476, 0.548382, 0.544258, 0.543926, 0.540005, 0.538831,
+                                      0.543222, 0.53448, 0.535014, 0.528731, 0.517457, 0.501963, 0.489472, 0.480086,
+                                      0.47594, 0.474252, 0.471684, 0.467381, 0.47002, 0.462449, 0.458279, 0.45573,
+                                      0.45085, 0.451388, 0.448358, 0.448926, 0.446427, 0.437154, 0.439613, 0.434813,
+                                      0.435781, 0.430242, 0.426984, 0.426776, 0.424525, 0.422673, 0.420809,
+                                      0.415454, 0.418039, 0.412673, 0.412611, 0.41453, 0.413378, 0.402649, 0.408683,
+                                      0.407647, 0.403596, 0.401837, 0.397678, 0.395147, 0.392898, 0.391702,
+                                      0.386557, 0.377788, 0.37777, 0.37069, 0.364217, 0.360065, 0.348944, 0.330525,
+                                      0.308675, 0.286825 };
+
+const G4double EBA_D_TilePMT[size] = { 0.83964, 0.797377, 0.755114, 0.758831, 0.750956, 0.727028, 0.710895, 0.7013,
+                                     0.696957, 0.678444, 0.675153, 0.659896, 0.656481, 0.6555, 0.648582, 0.64414,
+                                     0.634209, 0.63669, 0.630879, 0.626185, 0.610719, 0.616651, 0.608967, 0.597805,
+                                     0.601157, 0.599113, 0.589518, 0.581218, 0.582136, 0.577285, 0.576426, 0.566552,
+                                     0.565228, 0.554291, 0.552419, 0.555652, 0.545789, 0.54289, 0.537612, 0.537218,
+                                     0.539621, 0.528208, 0.529998, 0.530758, 0.532108, 0.522749, 0.511517, 0.51012,
+                                     0.499114, 0.490116, 0.480166, 0.474294, 0.463783, 0.464397, 0.467149, 0.460705,
+                                     0.452137, 0.446681, 0.449894, 0.44324, 0.438109, 0.437593, 0.433048, 0.437898,
+                                     0.429795, 0.425461, 0.428106, 0.42259, 0.42333, 0.417693, 0.416418, 0.413091,
+                                     0.412467, 0.415014, 0.408279, 0.402152, 0.406765, 0.403563, 0.395906, 0.399396,
+                                     0.396097, 0.395945, 0.387978, 0.389495, 0.386988, 0.382293, 0.374119, 0.367898,
+                                     0.366629, 0.359724, 0.358971, 0.353465, 0.352667, 0.348716, 0.352001, 0.340563,
+                                     0.319873, 0.320009, 0.320145 };*/
+
+//Array of tiles distances from center in the ATLAS Experiment (from athena).
+//In the simulation the beam position should be 2298 0 0 mm to get the same distances
+//
+static constexpr G4double tileRadius[11] = { 2350., 2450., 2550., 2680., 2810., 2940., 3090., 3240., 3390., 3580., 3770. };
+
+//tan() of the dPhi bin edges, padded with a sentinel at each end. The first
+//edge is one bin below the profile as the original truncation toward zero
+//puts dPhi bin -1 in the first bin. Taylor series to 11th order, exact to
+//double precision for |dPhi| < 0.06
+//
+constexpr G4double UShapeEdgeTan( G4int edge ) {
+    const G4double phi = ( (G4double) edge - uShapeHalfBins ) / uShapeBinsPerRad;
+    const G4double phi2 = phi * phi;
+    return phi * ( 1. + phi2 * ( 1. / 3. + phi2 * ( 2. / 15. + phi2 * ( 17. / 315. + phi2 * ( 62. / 2835. + phi2 * ( 1382. / 155925. ) ) ) ) ) );
+}
+
+constexpr std::size_t uShapeEdges = uShapeBins + 4;
+
+constexpr std::array<G4double, uShapeEdges> MakeUShapeEdges() {
+    std::array<G4double, uShapeEdges> edges {};
+    edges.front() = -DBL_MAX;
+    for ( std::size_t i = 1; i < uShapeEdges - 1; ++i ) edges[i] = UShapeEdgeTan( static_cast<G4int>(i) - 2 );
+    edges.back() = DBL_MAX;
+    return edges;
+}
+
+static constexpr std::array<G4double, uShapeEdges> uShapeEdgeTan = MakeUShapeEdges();
+
+//Bin of dPhi = atan(ratio) as int(dPhi * uShapeBinsPerRad + uShapeHalfBins),
+//-1 if outside the profile. The bin is found comparing the ratio to the tan()
+//of the edges, ratios within rounding distance of an edge use atan() to give
+//exactly the bin of the original implementation.
+//
+static G4int UShapeBin( G4double ratio ) {
+    constexpr G4double edgeTolerance = 1.e-12;
+    constexpr G4double lastPosition = (G4double) uShapeEdges - 2.;
+
+    // Position of ratio among the edges: uShapeEdgeTan[pos] <= ratio < uShapeEdgeTan[pos+1].
+    // tan(dPhi) ~ dPhi, the guess is at most one position away
+    const G4double guess = ratio * uShapeBinsPerRad + uShapeHalfBins + 2.;
+    G4int pos = static_cast<G4int>( std::min( std::max( guess, 0. ), lastPosition ) );
+    pos -= ( ratio < uShapeEdgeTan[pos] );
+    pos += ( ratio >= uShapeEdgeTan[pos + 1] );
+
+    if ( ratio - uShapeEdgeTan[pos] < edgeTolerance || uShapeEdgeTan[pos + 1] - ratio < edgeTolerance ) {
+        const G4int index = G4int( std::atan( ratio ) * uShapeBinsPerRad + uShapeHalfBins );
+        return ( index < 0 || index >= (G4int) uShapeBins ) ? -1 : index;
+    }
+
+    // position 1 is dPhi bin -1, truncated toward zero in the first bin
+    if ( pos < 1 || pos > (G4int) uShapeBins + 1 ) return -1;
+    return std::max( pos - 2, 0 );
+}
+
+//Tile_1D_profileRescaled method
+//This method is adapted from the ATLAS athena offline software
+//athena/TileCalorimeter/TileG4/TileGeoG4SD/src/TileGeoG4SDCalc.cc
+//as on June 2022. Both PMTs are evaluated at once, the up PMT
+//sees the mirrored dPhi.
+//
+ATLTileCalTBSensDet::UShapeResponse ATLTileCalTBSensDet::Tile_1D_profileRescaled( G4int row, G4double x, G4double y, UShape uShape/*, G4int nSide*/ ) const {
+
+    UShapeResponse response {0., 0.};
+
+    if (row < 0 || row >= 11) {
+        G4cout<<"-->ERROR in tile row"<<G4endl;
+        return response;
+    }
+
+    const G4double* profile = uShapeProfiles[static_cast<std::size_t>(uShape)];
+    const G4double ratio = x / (y + tileRadius[row]);
+
+    const G4int indexUp = UShapeBin( -ratio );
+    if ( indexUp < 0 ) G4cout<<"-->ERROR in U-shape index"<<G4endl;
+    else response.up = profile[indexUp];
+
+    const G4int indexDown = UShapeBin( ratio );
+    if ( indexDown < 0 ) G4cout<<"-->ERROR in U-shape index"<<G4endl;
+    else response.down = profile[indexDown];
+
+    return response;
 
 }
 
@@ -0,0 +1,106 @@
+//**************************************************
+// \file ATLTileCalTBShard.cc
+// \brief: implementation of ATLTileCalTBShard
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+//Includers from project files
+//
+#include "ATLTileCalTBShard.hh"
+
+//Includers from Geant4
+//
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+//Includers from C++
+//
+#include <cstdint>
+#include <sstream>
+
+namespace {
+    //SplitMix64 finalizer, a bijective mixing of the 64 bits
+    //
+    std::uint64_t SplitMix64( std::uint64_t x ) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+}
+
+//GetInstance() method
+//One instance per process, set by main() before the run manager starts
+//
+ATLTileCalTBShard* ATLTileCalTBShard::GetInstance() {
+    static ATLTileCalTBShard instance;
+    return &instance;
+}
+
+//Constructor and de-constructor
+//
+ATLTileCalTBShard::ATLTileCalTBShard()
+    : fIndex(0),
+      fCount(0),
+      fBaseSeed(0) {
+
+    //All the shards of a production must use the same base seed
+    //
+    fMessenger = new G4GenericMessenger(this, "/ATLTileCalTB/shard/", "Sharded runs");
+    fMessenger->DeclareProperty("seed", fBaseSeed,
+        "Base seed of the per-event seeds of sharded runs")
+        .SetStates(G4State_PreInit, G4State_Idle)
+        .SetToBeBroadcasted(false);
+
+}
+
+ATLTileCalTBShard::~ATLTileCalTBShard() {
+    delete fMessenger;
+}
+
+//SetShard() method
+//
+G4bool ATLTileCalTBShard::SetShard( const G4String& shard ) {
+    std::istringstream stream(shard);
+    G4int index = -1;
+    G4int count = 0;
+    char separator = ' ';
+    if ( !(stream >> index >> separator >> count) || separator != '/' || !stream.eof() ) return false;
+    if ( count < 1 || index < 0 || index >= count ) return false;
+    fIndex = index;
+    fCount = count;
+    return true;
+}
+
+//Reseed() method
+//The seeds only depend on the base seed, run ID and event ID
+//
+void ATLTileCalTBShard::Reseed( G4int runID, G4int eventID ) const {
+    const std::uint64_t event = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(runID)) << 32)
+                                | static_cast<std::uint32_t>(eventID);
+    const std::uint64_t key = SplitMix64( SplitMix64( static_cast<std::uint32_t>(fBaseSeed) ) ^ event );
+    //Two positive non-zero 30-bit seeds, zero terminates the list
+    long seeds[3] = { static_cast<long>(key & 0x3fffffffULL) + 1,
+                      static_cast<long>((key >> 32) & 0x3fffffffULL) + 1, 0 };
+    G4Random::setTheSeeds( seeds );
+}
+
+//GetFileSuffix() method
+//
+G4String ATLTileCalTBShard::GetFileSuffix() const {
+    if ( !IsActive() ) return "";
+    return "_Shard" + std::to_string(fIndex) + "of" + std::to_string(fCount);
+}
+
+//Print() method
+//
+void ATLTileCalTBShard::Print() const {
+    if ( !IsActive() ) return;
+    G4cout << "Shard " << fIndex << "/" << fCount << ": events with ID % " << fCount << " == " << fIndex
+           << ", per-event seeds from base seed " << fBaseSeed << G4endl;
+}
+
+//**************************************************
@@ -0,0 +1,41 @@
+//**************************************************
+// \file ATLTileCalTBSignalBuffer.cc
+// \brief: implementation of ATLTileCalTBSignalBuffer
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+//The buffer is only used with the dense hit layout
+#ifndef ATLTileCalTB_SparseHits
+
+//Includers from project files
+//
+#include "ATLTileCalTBSignalBuffer.hh"
+
+//Includers from C++
+//
+#include <cstring>
+
+//Constructor
+//
+ATLTileCalTBSignalBuffer::ATLTileCalTBSignalBuffer( std::size_t nCells, std::size_t nBins )
+    : fLinesPerPMT((nBins + fValuesPerLine - 1) / fValuesPerLine),
+      fLines(2 * nCells * fLinesPerPMT),
+      fViews(nCells, nullptr) {
+    std::memset(static_cast<void*>(fLines.data()), 0, fLines.size() * sizeof(Line));
+}
+
+//Destructor
+//Hits of kept events can outlive the sensitive detector
+//
+ATLTileCalTBSignalBuffer::~ATLTileCalTBSignalBuffer() {
+    for ( auto hit : fViews ) {
+        if ( hit ) hit->Detach();
+    }
+}
+
+#endif //ATLTileCalTB_SparseHits
+
+//**************************************************
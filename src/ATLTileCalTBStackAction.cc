@@ -0,0 +1,100 @@
+//**************************************************
+// \file ATLTileCalTBStackAction.cc
+// \brief: implementation of ATLTileCalTBStackAction
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+//Includers from project files
+//
+#include "ATLTileCalTBStackAction.hh"
+#include "ATLTileCalTBRunAction.hh"
+#include "ATLTileCalTBCulling.hh"
+
+//Includers from Geant4
+//
+#include "G4Track.hh"
+#ifdef ATLTileCalTB_SubEvent
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VProcess.hh"
+#endif
+
+//Includers from C++
+//
+#ifdef ATLTileCalTB_SubEvent
+#include <cstdlib>
+#endif
+
+//Constructor and de-constructor
+//
+#ifdef ATLTileCalTB_SubEvent
+ATLTileCalTBStackAction::ATLTileCalTBStackAction( ATLTileCalTBRunAction* runAction )
+    : G4UserStackingAction(),
+      fRunAction( runAction ),
+      fCulling( ATLTileCalTBCulling::GetInstance() ),
+      fSubEventMinEnergy( 30.*GeV ),
+      fSubEvents( false ) {
+
+    fMessenger = new G4GenericMessenger(this, "/ATLTileCalTB/subevent/", "Sub-event parallel mode");
+    fMessenger->DeclarePropertyWithUnit("minEnergy", "GeV", fSubEventMinEnergy,
+        "Minimum energy of the primary hadron to send the secondaries of its first interaction to sub-events");
+
+}
+
+ATLTileCalTBStackAction::~ATLTileCalTBStackAction() {
+    delete fMessenger;
+}
+#else
+ATLTileCalTBStackAction::ATLTileCalTBStackAction( ATLTileCalTBRunAction* runAction )
+    : G4UserStackingAction(),
+      fRunAction( runAction ),
+      fCulling( ATLTileCalTBCulling::GetInstance() ) {}
+
+ATLTileCalTBStackAction::~ATLTileCalTBStackAction() {}
+#endif
+
+//ClassifyNewTrack() method
+//Secondaries created after the signal time window are killed
+//before being transported
+//
+G4ClassificationOfNewTrack ATLTileCalTBStackAction::ClassifyNewTrack( const G4Track* track ) {
+
+    if ( fCulling->ToBeCulled( track ) ) {
+        fRunAction->AddCulledTrack( track->GetKineticEnergy() );
+        return fKill;
+    }
+    #ifdef ATLTileCalTB_SubEvent
+    //Each secondary of the hadronic interactions of the primary
+    //starts a shower that can be tracked by another thread
+    if ( fSubEvents && track->GetParentID() == 1 && track->GetCreatorProcess()
+         && track->GetCreatorProcess()->GetProcessType() == fHadronic ) {
+        return fSubEvent_0;
+    }
+    #endif
+    return fUrgent;
+
+}
+
+#ifdef ATLTileCalTB_SubEvent
+//PrepareNewEvent() method
+//Sub-events are only spawned by events of high-energy hadrons,
+//sub-events themselves have no primary vertex
+//
+void ATLTileCalTBStackAction::PrepareNewEvent() {
+    fSubEvents = false;
+    const auto event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+    if ( !event || event->GetNumberOfPrimaryVertex() == 0 ) return;
+    const auto primary = event->GetPrimaryVertex()->GetPrimary();
+    const auto pdgID = std::abs( primary->GetPDGcode() );
+    const G4bool isEM = pdgID == 11 || pdgID == 22;
+    fSubEvents = !isEM && primary->GetKineticEnergy() >= fSubEventMinEnergy;
+}
+#endif
+
+//**************************************************
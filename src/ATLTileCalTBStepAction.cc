@@ -10,15 +10,19 @@
 //Includers from project files
 //
 #include "ATLTileCalTBStepAction.hh"
+#include "ATLTileCalTBRunAction.hh"
 #ifdef ATLTileCalTB_LEAKANALYSIS
 #include "SpectrumAnalyzer.hh"
 #endif
 
 //Constructor and de-constructor
 //
-ATLTileCalTBStepAction::ATLTileCalTBStepAction(ATLTileCalTBEventAction* EventAction)
+ATLTileCalTBStepAction::ATLTileCalTBStepAction(ATLTileCalTBEventAction* EventAction, ATLTileCalTBRunAction* RunAction)
     : G4UserSteppingAction(),
-      fEventAction( EventAction ){}
+      fEventAction( EventAction ),
+      fRunAction( RunAction ),
+      fVolumeRoles( ATLTileCalTBGeometry::VolumeRoleTable::GetInstance() ),
+      fCulling( ATLTileCalTBCulling::GetInstance() ){}
 
 ATLTileCalTBStepAction::~ATLTileCalTBStepAction() {}
 
@@ -35,8 +39,9 @@ void ATLTileCalTBStepAction::UserSteppingAction( const G4Step* aStep ) {
         #endif
     }
 
-    if ( aStep->GetTrack()->GetTouchableHandle()->GetVolume()->GetName() != "CALO::CALO" ||
-         aStep->GetTrack()->GetTouchableHandle()->GetVolume()->GetName() != "Barrel" ) {
+    using ATLTileCalTBGeometry::VolumeRole;
+    if ( !fVolumeRoles->HasAnyRole( aStep->GetTrack()->GetTouchableHandle()->GetVolume()->GetLogicalVolume(),
+                                    VolumeRole::CaloEnvelope | VolumeRole::Barrel ) ) {
  
         //Collect calo energy deposition (everything but what goes into CALO::CALO and Barrel) 
         //Warning: not exact measurement
@@ -45,6 +50,15 @@ void ATLTileCalTBStepAction::UserSteppingAction( const G4Step* aStep ) {
     
     }
 
+    //Kill the tracks crossing the signal time window, this step
+    //and its secondaries are already processed
+    //
+    auto track = aStep->GetTrack();
+    if ( track->GetTrackStatus() == fAlive && fCulling->ToBeCulled( track ) ) {
+        fRunAction->AddCulledTrack( track->GetKineticEnergy() );
+        track->SetTrackStatus( fStopAndKill );
+    }
+
 }
 
 //**************************************************
@@ -0,0 +1,36 @@
+//**************************************************
+// \file ATLTileCalTBStepBuffer.cc
+// \brief: implementation of ATLTileCalTBStepBuffer
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+//Includers from project files
+//
+#include "ATLTileCalTBStepBuffer.hh"
+
+//Constructor
+//All the columns are allocated once, Push() never reallocates
+//
+ATLTileCalTBStepBuffer::ATLTileCalTBStepBuffer( std::size_t capacity )
+    : cell(capacity),
+      row(capacity),
+      uShape(capacity),
+      y(capacity),
+      z(capacity),
+      time(capacity),
+      edep(capacity),
+      weight(capacity),
+      length(capacity),
+      charge(capacity),
+      density(capacity),
+      frame(capacity),
+      sdep(capacity),
+      up(capacity),
+      down(capacity),
+      fCapacity(capacity),
+      fSize(0) {}
+
+//**************************************************
@@ -0,0 +1,170 @@
+//**************************************************
+// \file ATLTileCalTBTimeBinning.cc
+// \brief: implementation of ATLTileCalTBTimeBinning
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+//Includers from project files
+//
+#include "ATLTileCalTBTimeBinning.hh"
+
+//Includers from Geant4
+//
+#include "G4ios.hh"
+#include "G4UnitsTable.hh"
+
+//GetInstance() method
+//One instance per process, configured by the master thread before initialization
+//
+ATLTileCalTBTimeBinning* ATLTileCalTBTimeBinning::GetInstance() {
+    static ATLTileCalTBTimeBinning instance;
+    return &instance;
+}
+
+//Constructor and de-constructor
+//
+ATLTileCalTBTimeBinning::ATLTileCalTBTimeBinning()
+    : fTimeWindow(ATLTileCalTBConstants::frame_time_window),
+      fFineBinningLimit(ATLTileCalTBConstants::frame_time_window),
+      fCoarseBinTime(ATLTileCalTBConstants::frame_bin_time) {
+
+    Update();
+
+    //Commands are only allowed before initialization and not broadcasted,
+    //as the binning is shared by all threads
+    //
+    fMessenger = new G4GenericMessenger(this, "/ATLTileCalTB/digi/", "Digitization control");
+    fMessenger->DeclareMethodWithUnit("timeWindow", "ns", &ATLTileCalTBTimeBinning::SetTimeWindow,
+        "Time window for signal deposits (at most 350 ns)")
+        .SetStates(G4State_PreInit)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclareMethodWithUnit("fineBinningLimit", "ns", &ATLTileCalTBTimeBinning::SetFineBinningLimit,
+        "Deposits are binned with 0.5 ns bins up to this time, with the coarse bin width after it")
+        .SetStates(G4State_PreInit)
+        .SetToBeBroadcasted(false);
+    fMessenger->DeclareMethodWithUnit("coarseBinWidth", "ns", &ATLTileCalTBTimeBinning::SetCoarseBinTime,
+        "Bin width after the fine-binning limit (multiple of 0.5 ns)")
+        .SetStates(G4State_PreInit)
+        .SetToBeBroadcasted(false);
+
+}
+
+ATLTileCalTBTimeBinning::~ATLTileCalTBTimeBinning() {
+    delete fMessenger;
+}
+
+//Set methods
+//
+void ATLTileCalTBTimeBinning::SetTimeWindow( G4double time ) {
+    using namespace ATLTileCalTBConstants;
+    if ( time <= 0. || time > frame_time_window ) {
+        G4ExceptionDescription msg;
+        msg << "Time window " << G4BestUnit(time, "Time") << " outside of (0, "
+            << G4BestUnit(frame_time_window, "Time") << "]." << G4endl;
+        G4Exception("ATLTileCalTBTimeBinning::SetTimeWindow()",
+        "MyCode0009", FatalErrorInArgument, msg);
+    }
+    fTimeWindow = time;
+    Update();
+}
+
+void ATLTileCalTBTimeBinning::SetFineBinningLimit( G4double time ) {
+    using namespace ATLTileCalTBConstants;
+    auto frame = std::round(time / frame_bin_time);
+    if ( time < 0. || std::abs(frame * frame_bin_time - time) > 1e-6 * frame_bin_time ) {
+        G4ExceptionDescription msg;
+        msg << "Fine-binning limit " << G4BestUnit(time, "Time") << " is not a non-negative multiple of "
+            << G4BestUnit(frame_bin_time, "Time") << "." << G4endl;
+        G4Exception("ATLTileCalTBTimeBinning::SetFineBinningLimit()",
+        "MyCode0009", FatalErrorInArgument, msg);
+    }
+    fFineBinningLimit = frame * frame_bin_time;
+    Update();
+}
+
+void ATLTileCalTBTimeBinning::SetCoarseBinTime( G4double time ) {
+    using namespace ATLTileCalTBConstants;
+    auto ratio = std::round(time / frame_bin_time);
+    if ( ratio < 1. || std::abs(ratio * frame_bin_time - time) > 1e-6 * frame_bin_time ) {
+        G4ExceptionDescription msg;
+        msg << "Coarse bin width " << G4BestUnit(time, "Time") << " is not a multiple of "
+            << G4BestUnit(frame_bin_time, "Time") << "." << G4endl;
+        G4Exception("ATLTileCalTBTimeBinning::SetCoarseBinTime()",
+        "MyCode0009", FatalErrorInArgument, msg);
+    }
+    fCoarseBinTime = ratio * frame_bin_time;
+    Update();
+}
+
+//Update() method
+//The commands can come in any order, so an unsupported configuration
+//is only refused when used (CheckBinning())
+//
+void ATLTileCalTBTimeBinning::Update() {
+    using namespace ATLTileCalTBConstants;
+    const auto windowFrames = static_cast<std::size_t>(std::ceil(fTimeWindow / frame_bin_time - 1e-6));
+    const auto fineFrames = static_cast<std::size_t>(std::round(fFineBinningLimit / frame_bin_time));
+    const auto coarseFrames = static_cast<std::size_t>(std::round(fCoarseBinTime / frame_bin_time));
+    const G4bool uniform = ( fineFrames >= windowFrames || coarseFrames == 1 );
+
+    fBinning = SIZE_MAX;
+    for ( std::size_t i = 0; i < std::tuple_size_v<ATLTileCalTBBinnings::List>; ++i ) {
+        VisitBinning(i, [&]( auto binning ) {
+            using Binning = decltype(binning);
+            if ( Binning::windowFrames < windowFrames || Binning::uniform != uniform ) return;
+            if ( ! uniform && ( Binning::fineFrames != fineFrames || Binning::coarseFrames != coarseFrames ) ) return;
+            if ( fBinning != SIZE_MAX && Binning::windowFrames >= fWindowFrames ) return;
+            fBinning = i;
+            fWindowFrames = Binning::windowFrames;
+            fFineFrames = Binning::fineFrames;
+            fCoarseFrames = Binning::coarseFrames;
+            fBins = Binning::bins;
+        });
+    }
+}
+
+//CheckBinning() method
+//
+void ATLTileCalTBTimeBinning::CheckBinning() const {
+    if ( fBinning != SIZE_MAX ) return;
+    G4ExceptionDescription msg;
+    msg << "No digitization is compiled for a " << G4BestUnit(fTimeWindow, "Time") << " time window with "
+        << G4BestUnit(ATLTileCalTBConstants::frame_bin_time, "Time") << " bins up to "
+        << G4BestUnit(fFineBinningLimit, "Time") << " and " << G4BestUnit(fCoarseBinTime, "Time")
+        << " bins after, the supported binnings are (window, fine-binning limit, coarse bin width):";
+    for ( std::size_t i = 0; i < std::tuple_size_v<ATLTileCalTBBinnings::List>; ++i ) {
+        VisitBinning(i, [&msg]( auto binning ) {
+            using Binning = decltype(binning);
+            using ATLTileCalTBConstants::frame_bin_time;
+            msg << G4endl << "  " << G4BestUnit(Binning::windowFrames * frame_bin_time, "Time") << ", ";
+            if ( Binning::uniform ) msg << "uniform";
+            else msg << G4BestUnit(Binning::fineFrames * frame_bin_time, "Time") << ", "
+                     << G4BestUnit(Binning::coarseFrames * frame_bin_time, "Time");
+        });
+    }
+    msg << G4endl << "with any shorter time window." << G4endl;
+    G4Exception("ATLTileCalTBTimeBinning::CheckBinning()",
+    "MyCode0009", FatalException, msg);
+}
+
+//Print() method
+//
+void ATLTileCalTBTimeBinning::Print() const {
+    using ATLTileCalTBConstants::frame_bin_time;
+    CheckBinning();
+    G4cout << "Signal time window: " << G4BestUnit(fTimeWindow, "Time");
+    if ( fFineFrames == fWindowFrames || fCoarseFrames == 1 ) {
+        G4cout << " with " << G4BestUnit(frame_bin_time, "Time") << " bins";
+    }
+    else {
+        G4cout << " with " << G4BestUnit(frame_bin_time, "Time") << " bins up to "
+               << G4BestUnit(fFineBinningLimit, "Time") << " and "
+               << G4BestUnit(fCoarseBinTime, "Time") << " bins after";
+    }
+    G4cout << " (" << fBins << " bins per PMT over " << G4BestUnit(fWindowFrames * frame_bin_time, "Time") << ")" << G4endl;
+}
+
+//**************************************************
@@ -0,0 +1,80 @@
+//**************************************************
+// \file ATLTileCalTBVDigitizer.cc
+// \brief: implementation of ATLTileCalTBVDigitizer
+//         class
+// \author: agent
+//          agent@local
+// \start date: 18 October 2026
+//**************************************************
+
+//Includers from project files
+//
+#include "ATLTileCalTBVDigitizer.hh"
+#include "ATLTileCalTBDigitizer.hh"
+#include "ATLTileCalTBTimeBinning.hh"
+
+//Includers from C++
+//
+#include <numeric>
+
+//Create() method
+//The binning is fixed at initialization, the digitizer is created
+//when first needed
+//
+std::unique_ptr<ATLTileCalTBVDigitizer> ATLTileCalTBVDigitizer::Create() {
+    return ATLTileCalTBTimeBinning::GetInstance()->Visit( []( auto binning ) -> std::unique_ptr<ATLTileCalTBVDigitizer> {
+        return std::make_unique<ATLTileCalTBDigitizer<decltype(binning)>>();
+    } );
+}
+
+//Constructor and de-constructor
+//
+ATLTileCalTBVDigitizer::ATLTileCalTBVDigitizer() {
+
+    //Optimal filtering weights for white noise.
+    //A pulse of amplitude A and phase tau gives samples S = A g - A tau g',
+    //with g and g' the normalized response and its derivative at the sampling times.
+    //The weights a (b) minimize the variance of sum(a S) = A (sum(b S) = A tau)
+    //with the constraints a.g = 1, a.g' = 0 (b.g = 0, b.g' = -1),
+    //so a = lambda g + kappa g' (b = mu g + rho g') with the Gram matrix of g and g'.
+    //
+    using namespace ATLTileCalTBConstants;
+    const G4double peakValue = pmt_response[fOFPeakFrame];
+    Samples g, dg;
+    for ( std::size_t i = 0; i < of_samples; ++i ) {
+        fOFFrames[i] = fOFPeakFrame + i * fOFStep - (of_samples / 2) * fOFStep;
+        const auto j = fOFFrames[i];
+        g[i] = (j < pmt_response.size()) ? pmt_response[j] / peakValue : 0.;
+        dg[i] = (j > 0 && j + 1 < pmt_response.size()) ?
+                (pmt_response[j + 1] - pmt_response[j - 1]) / (2. * frame_bin_time) / peakValue : 0.;
+    }
+    const G4double gg = std::inner_product(g.begin(), g.end(), g.begin(), 0.);
+    const G4double gdg = std::inner_product(g.begin(), g.end(), dg.begin(), 0.);
+    const G4double dgdg = std::inner_product(dg.begin(), dg.end(), dg.begin(), 0.);
+    const G4double det = gg * dgdg - gdg * gdg;
+    const G4double lambda = dgdg / det, kappa = -gdg / det;
+    const G4double mu = gdg / det, rho = -gg / det;
+    for ( std::size_t i = 0; i < of_samples; ++i ) {
+        fOFWeightsA[i] = lambda * g[i] + kappa * dg[i];
+        fOFWeightsB[i] = mu * g[i] + rho * dg[i];
+    }
+
+}
+
+ATLTileCalTBVDigitizer::~ATLTileCalTBVDigitizer() {}
+
+//GetOFAmplitude() method
+//
+G4double ATLTileCalTBVDigitizer::GetOFAmplitude( const Samples& samples ) const {
+    return std::inner_product(fOFWeightsA.begin(), fOFWeightsA.end(), samples.begin(), 0.);
+}
+
+//GetOFPhase() method
+//Time of the pulse peak with respect to the central sample
+//
+G4double ATLTileCalTBVDigitizer::GetOFPhase( const Samples& samples, G4double amplitude ) const {
+    if ( amplitude == 0. ) return 0.;
+    return std::inner_product(fOFWeightsB.begin(), fOFWeightsB.end(), samples.begin(), 0.) / amplitude;
+}
+
+//**************************************************
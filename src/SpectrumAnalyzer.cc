@@ -36,6 +36,8 @@ void SpectrumAnalyzer::CreateNtupleAndScorer(const G4String scName)
   AM->CreateNtupleDColumn("gammaScore");
   AM->CreateNtupleDColumn("electronScore");
   AM->CreateNtupleDColumn("othersScore");
+  // Rows are matched to the events by ID, the main ntuple rows can be filled later
+  AM->CreateNtupleIColumn("EventID");
   AM->FinishNtuple();
 
   // Define scorer type
@@ -58,7 +60,7 @@ void SpectrumAnalyzer::CreateNtupleAndScorer(const G4String scName)
   }  // default case
 }
 
-void SpectrumAnalyzer::FillEventFields() const
+void SpectrumAnalyzer::FillEventFields(G4int eventID) const
 {
   auto AM = G4AnalysisManager::Instance();
   AM->FillNtupleDColumn(ntupleID, 0, neutronScore);
@@ -67,6 +69,7 @@ void SpectrumAnalyzer::FillEventFields() const
   AM->FillNtupleDColumn(ntupleID, 3, gammaScore);
   AM->FillNtupleDColumn(ntupleID, 4, electronScore);
   AM->FillNtupleDColumn(ntupleID, 5, othersScore);
+  AM->FillNtupleIColumn(ntupleID, 6, eventID);
   AM->AddNtupleRow(ntupleID);
 }
 